@@ -1,12 +1,20 @@
 #include <glad/glad.h> 
 #include <GLFW/glfw3.h>
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <vector>
 #include <string>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <memory>
+#include <optional>
+#include <thread>
 #include <algorithm> 
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib> // Para rand()
 #include <ctime>   // Para time()
 
@@ -14,21 +22,58 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-// --- ESTRUTURAS ---
-struct Ponto { glm::vec3 posicao; };
-struct Segmento { int indicePontoA; int indicePontoB; float raio; glm::vec3 cor; }; // Adicionamos COR aqui
-struct Arvore2D { std::vector<Ponto> vertices; std::vector<Segmento> segmentos; };
+#include "anel_ingestao.h"
+#include "arena_arvore.h"
+#include "arvore.h"
+#include "camera_orbita.h"
+#include "cache_blocos.h"
+#include "carregador_vtk.h"
+#include "catalogo.h"
+#include "consulta_caminhos.h"
+#include "grade_segmentos.h"
+#include "hemodinamica.h"
+#include "modo_bench.h"
+#include "ordem_morton.h"
+#include "perfilador.h"
+#include "programas_gl.h"
+#include "pool_tarefas.h"
+#include "rastreio.h"
+#include "refinamento.h"
+#include "topologia.h"
 
 // --- VARIÁVEIS GLOBAIS ---
 glm::vec3 cameraPos = glm::vec3(0.0f, 0.0f, 0.0f);
 float zoomLevel = 1.0f;
 float anguloRotacao = 0.0f;
 
+// Câmera 3D (arquivos com z): órbita pelo teclado, arcball com o botão esquerdo, zoom na roda
+bool modo3D = false;
+CameraOrbita camera3D;
+bool arrastando = false;
+double ultimoCursorX = 0.0, ultimoCursorY = 0.0;
+
+// Velocidades por segundo: o movimento não depende mais do fps
+// (os valores reproduzem os antigos passos por frame a 60 fps)
+const float VEL_PAN = 1.2f;      // tela por segundo (dividido pelo zoom no 2D)
+const float VEL_ZOOM = 3.28f;    // fator por segundo (1.02 por frame)
+const float VEL_GIRO = 60.0f;    // graus por segundo
+
 // Controle de Crescimento
 int segmentosVisiveis = 0;
 int totalSegmentos = 0;
-float ultimoTempoCrescimento = 0.0f;
-float delayCrescimento = 0.05f;
+float taxaCrescimento = 20.0f;        // segmentos por segundo com K/J (Shift: 1000)
+float acumuladorCrescimento = 1.0f;   // fração de segmento pendente; 1 = o toque já dá um passo
+
+// Instrumentação (F1 liga/desliga o HUD)
+bool hudVisivel = false;
+
+// Desenho sob demanda: callbacks e processInput marcam a cena como suja e o
+// loop dorme em glfwWaitEventsTimeout enquanto nada muda
+bool precisaDesenhar = true;
+
+// Seleção de vasos (botão direito): tratada no loop, onde a árvore e a matriz estão
+bool cliquePendente = false;
+double cliqueX = 0.0, cliqueY = 0.0;
 
 // --- SHADERS ATUALIZADOS PARA RECEBER COR ---
 const char* vertexShaderSource = "#version 330 core\n"
@@ -49,224 +94,913 @@ const char* fragmentShaderSource = "#version 330 core\n"
 // --- CALLBACKS ---
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
     glViewport(0, 0, width, height);
+    precisaDesenhar = true;
 }
 
-void processInput(GLFWwindow *window) {
+void window_refresh_callback(GLFWwindow* window) {
+    precisaDesenhar = true;
+}
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    if (key == GLFW_KEY_F1 && action == GLFW_PRESS) { hudVisivel = !hudVisivel; precisaDesenhar = true; }
+}
+
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
+    if (button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_PRESS) {
+        glfwGetCursorPos(window, &cliqueX, &cliqueY);
+        cliquePendente = true;
+        precisaDesenhar = true;
+    }
+    if (button == GLFW_MOUSE_BUTTON_LEFT && modo3D) {
+        arrastando = action == GLFW_PRESS;
+        glfwGetCursorPos(window, &ultimoCursorX, &ultimoCursorY);
+    }
+}
+
+void cursor_pos_callback(GLFWwindow* window, double x, double y) {
+    if (!arrastando) return;
+    int w, h; glfwGetWindowSize(window, &w, &h);
+    float m = (float)std::max(1, std::min(w, h));
+    auto tela = [&](double cx, double cy) { return glm::vec2((2.0f * (float)cx - w) / m, (h - 2.0f * (float)cy) / m); };
+    camera3D.arcball(tela(ultimoCursorX, ultimoCursorY), tela(x, y));
+    ultimoCursorX = x; ultimoCursorY = y;
+    precisaDesenhar = true;
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
+    if (modo3D) { camera3D.aproximar(std::pow(1.1f, (float)yoffset)); precisaDesenhar = true; }
+}
+
+// Devolve true enquanto alguma tecla de controle estiver pressionada: o loop
+// continua desenhando no ritmo do vsync até ela ser solta. 'dt' é o tempo
+// desde a última chamada, em segundos.
+bool processInput(GLFWwindow *window, float dt) {
+    bool ativo = false;
+    auto tecla = [&](int k) { bool p = glfwGetKey(window, k) == GLFW_PRESS; ativo |= p; return p; };
+
     if(glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
 
-    float velPan = 0.02f / zoomLevel; 
-    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)    cameraPos.y -= velPan;
-    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)  cameraPos.y += velPan;
-    if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)  cameraPos.x += velPan;
-    if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) cameraPos.x -= velPan;
-    
-    if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) zoomLevel *= 1.02f;
-    if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) zoomLevel *= 0.98f;
-    
-    if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) anguloRotacao += 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS) anguloRotacao -= 1.0f;
-
-    float tempoAtual = glfwGetTime();
-    float delayAtual = (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) ? 0.001f : delayCrescimento;
-
-    if (tempoAtual - ultimoTempoCrescimento > delayAtual) {
-        if (glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS) { segmentosVisiveis++; ultimoTempoCrescimento = tempoAtual; }
-        if (glfwGetKey(window, GLFW_KEY_J) == GLFW_PRESS) { segmentosVisiveis--; ultimoTempoCrescimento = tempoAtual; }
+    float zoom = std::pow(VEL_ZOOM, dt);
+    if (modo3D) {
+        // Mesmas teclas do 2D (setas, Q/E, R/T) mais W/S e A/D para orbitar
+        float pan = VEL_PAN * dt;
+        float giro = glm::radians(VEL_GIRO) * dt;
+        if (tecla(GLFW_KEY_UP))    camera3D.deslocar(0.0f, -pan);
+        if (tecla(GLFW_KEY_DOWN))  camera3D.deslocar(0.0f, pan);
+        if (tecla(GLFW_KEY_LEFT))  camera3D.deslocar(pan, 0.0f);
+        if (tecla(GLFW_KEY_RIGHT)) camera3D.deslocar(-pan, 0.0f);
+        if (tecla(GLFW_KEY_Q)) camera3D.aproximar(zoom);
+        if (tecla(GLFW_KEY_E)) camera3D.aproximar(1.0f / zoom);
+        if (tecla(GLFW_KEY_R)) camera3D.girar(glm::vec3(0.0f, 0.0f, 1.0f), -giro);
+        if (tecla(GLFW_KEY_T)) camera3D.girar(glm::vec3(0.0f, 0.0f, 1.0f), giro);
+        if (tecla(GLFW_KEY_W)) camera3D.girar(glm::vec3(1.0f, 0.0f, 0.0f), -giro);
+        if (tecla(GLFW_KEY_S)) camera3D.girar(glm::vec3(1.0f, 0.0f, 0.0f), giro);
+        if (tecla(GLFW_KEY_A)) camera3D.girar(glm::vec3(0.0f, 1.0f, 0.0f), -giro);
+        if (tecla(GLFW_KEY_D)) camera3D.girar(glm::vec3(0.0f, 1.0f, 0.0f), giro);
+    } else {
+        float velPan = VEL_PAN * dt / zoomLevel; 
+        if (tecla(GLFW_KEY_UP))    cameraPos.y -= velPan;
+        if (tecla(GLFW_KEY_DOWN))  cameraPos.y += velPan;
+        if (tecla(GLFW_KEY_LEFT))  cameraPos.x += velPan;
+        if (tecla(GLFW_KEY_RIGHT)) cameraPos.x -= velPan;
+        
+        if (tecla(GLFW_KEY_Q)) zoomLevel *= zoom;
+        if (tecla(GLFW_KEY_E)) zoomLevel /= zoom;
+        
+        if (tecla(GLFW_KEY_R)) anguloRotacao += VEL_GIRO * dt;
+        if (tecla(GLFW_KEY_T)) anguloRotacao -= VEL_GIRO * dt;
+    }
+
+    // Crescimento: acumula frações de segmento; segurar dá 'taxa' por segundo em qualquer fps
+    bool crescer = tecla(GLFW_KEY_K), encolher = tecla(GLFW_KEY_J);
+    float taxa = (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) ? 1000.0f : taxaCrescimento;
+    if (crescer != encolher) {
+        acumuladorCrescimento += taxa * dt;
+        int passos = (int)acumuladorCrescimento;
+        acumuladorCrescimento -= passos;
+        segmentosVisiveis += crescer ? passos : -passos;
         segmentosVisiveis = std::max(0, std::min(segmentosVisiveis, totalSegmentos));
+    } else {
+        acumuladorCrescimento = 1.0f;
     }
+    return ativo;
+}
+
+// Caches (binários de shader, índice do catálogo) em $XDG_CACHE_HOME/tp1_cco (ou ~/.cache/...)
+std::string diretorioCache() {
+    const char* xdg = std::getenv("XDG_CACHE_HOME");
+    const char* home = std::getenv("HOME");
+    if (xdg && *xdg) return std::string(xdg) + "/tp1_cco";
+    if (home && *home) return std::string(home) + "/.cache/tp1_cco";
+    return "";
 }
 
-// --- PARSER ---
-Arvore2D carregarVTK(const std::string& caminho) {
-    Arvore2D arvore;
-    std::ifstream ficheiro(caminho);
-    std::string linha;
-    if (!ficheiro.is_open()) {
-        std::cerr << "ERRO: Nao consegui abrir " << caminho << std::endl;
-        return arvore;
+// --- VISUALIZADOR (instanciado para 2D e 3D) ---
+struct OpcoesVisualizador {
+    bool modoBench = false;
+    ConfigBench bench;
+    std::string caminhoCSV, caminhoRelatorio, tituloBase;
+    const PermutacaoArvore* permutacao = nullptr;   // índices do arquivo continuam sendo os exibidos ao usuário
+    std::string cacheShaders;                       // vazio = sem cache de binários
+    bool continuo = false;                          // redesenha todo frame, como antes do modo sob demanda
+    uint64_t inicioPrograma = 0;                    // != 0: imprime o tempo até o primeiro frame
+    bool blocos = false;                            // 2D: compõe blocos em cache durante pan/zoom
+    double orcamentoProgressivo = 0.0;              // ms de GPU por frame; > 0 liga o refinamento progressivo
+    AnelIngestao* aoVivo = nullptr;                 // drenado a cada frame; a árvore começa vazia
+};
+
+// --- CENA NA CPU (não precisa do contexto GL) ---
+template <int D>
+struct CenaCPU {
+    std::pmr::vector<int> ordemDesenho, posicaoNoBuffer;   // vazios em 2D (ordem do arquivo)
+    std::pmr::vector<VerticeGPU<D>> dadosGPU;
+    explicit CenaCPU(std::pmr::memory_resource* recurso)
+        : ordemDesenho(recurso), posicaoNoBuffer(recurso), dadosGPU(recurso) {}
+};
+
+// 2. PREPARAR BUFFERS COM COR (Position + Color)
+// ----------------------------------------------
+template <int D>
+void montarCena(const Arvore2D& minhaArvore, CenaCPU<D>& cena, bool ordenarPorRaio) {
+    uint64_t inicioDados = rastreio::agoraUs();
+    // Em 3D o buffer vai do tronco (mais grosso) aos terminais: o que cobre mais
+    // tela é desenhado antes e o early-z descarta os fragmentos escondidos atrás
+    // dele. K/J passa a crescer nessa ordem. O refinamento progressivo pede a
+    // mesma ordem também em 2D (qualquer prefixo é o "mais importante").
+    const auto& segmentos = minhaArvore.segmentos;
+    int nSegmentos = (int)segmentos.size();
+    auto& ordemDesenho = cena.ordemDesenho;
+    auto& posicaoNoBuffer = cena.posicaoNoBuffer;
+    if (D == 3 || ordenarPorRaio) {
+        ordemDesenho.resize(nSegmentos);
+        for (int i = 0; i < nSegmentos; i++) ordemDesenho[i] = i;
+        std::stable_sort(ordemDesenho.begin(), ordemDesenho.end(),
+                         [&](int a, int b) { return segmentos[a].raio > segmentos[b].raio; });
+        posicaoNoBuffer.resize(nSegmentos);
+        for (int i = 0; i < nSegmentos; i++) posicaoNoBuffer[ordemDesenho[i]] = i;
     }
+    // Dois vértices por segmento: D floats de posição (em 2D o z é descartado) + cor
+    auto& dadosGPU = cena.dadosGPU;
+    dadosGPU.reserve((size_t)nSegmentos * 2);
+    for (int i = 0; i < nSegmentos; i++) {
+        const Segmento& s = segmentos[ordemDesenho.empty() ? i : ordemDesenho[i]];
+        dadosGPU.push_back({glm::vec<D, float>(minhaArvore.vertices[s.indicePontoA].posicao), s.cor});
+        dadosGPU.push_back({glm::vec<D, float>(minhaArvore.vertices[s.indicePontoB].posicao), s.cor});
+    }
+
+    rastreio::completo("montar dadosGPU", inicioDados, rastreio::agoraUs());
+}
 
-    // Semente aleatória para cores
-    srand(time(NULL));
+template <int D>
+int visualizar(GLFWwindow* window, Arvore2D& minhaArvore, CenaCPU<D>& cena, const OpcoesVisualizador& opcoes) {
+    auto indiceArquivo = [&](int s) { return opcoes.permutacao->vazia() ? s : opcoes.permutacao->segmentoOriginal[s]; };
 
-    std::string estadoAtual = "HEADER";
-    int indiceRaioAtual = 0;
-    while (std::getline(ficheiro, linha)) {
-        if (linha.empty()) continue;
-        std::stringstream ss(linha); std::string palavra; ss >> palavra;
-        
-        if (palavra == "POINTS") { estadoAtual = "POINTS"; int n; ss >> n; arvore.vertices.reserve(n); continue; }
-        else if (palavra == "LINES") { estadoAtual = "LINES"; int n; ss >> n; arvore.segmentos.reserve(n); continue; }
-        else if (palavra == "CELL_DATA") { estadoAtual = "CELL_DATA"; continue; }
-        else if (palavra == "scalars" || palavra == "LOOKUP_TABLE") continue; 
-
-        if (estadoAtual == "POINTS") {
-            std::stringstream ss_l(linha); Ponto p; ss_l >> p.posicao.x >> p.posicao.y >> p.posicao.z;
-            arvore.vertices.push_back(p);
-        } else if (estadoAtual == "LINES") {
-            std::stringstream ss_l(linha); int n; Segmento s; ss_l >> n >> s.indicePontoA >> s.indicePontoB;
-            if (n==2) { 
-                s.raio=0.0f; 
-                
-                // GERA COR ALEATÓRIA VIBRANTE PARA CADA SEGMENTO
-                // Evitamos cores muito escuras garantindo um mínimo de 0.2
-                float r = (rand() % 100) / 100.0f;
-                float g = (rand() % 100) / 100.0f;
-                float b = (rand() % 100) / 100.0f;
-                
-                // Opção: Se quiser distinguir vizinhos, random total é o melhor.
-                s.cor = glm::vec3(r, g, b);
-
-                arvore.segmentos.push_back(s); 
+    std::pmr::memory_resource* arena = minhaArvore.segmentos.get_allocator().resource();
+    int nSegmentos = (int)minhaArvore.segmentos.size();
+    const auto& ordemDesenho = cena.ordemDesenho;
+    const auto& posicaoNoBuffer = cena.posicaoNoBuffer;
+    auto segmentoNaPosicao = [&](int i) { return ordemDesenho.empty() ? i : ordemDesenho[i]; };
+    auto posicaoDoSegmento = [&](int s) { return posicaoNoBuffer.empty() ? s : posicaoNoBuffer[s]; };
+    auto& dadosGPU = cena.dadosGPU;
+
+    unsigned int VBO, VAO;
+    glGenVertexArrays(1, &VAO); glGenBuffers(1, &VBO);
+    glBindVertexArray(VAO); glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    {
+        RASTREIO_ESCOPO("glBufferData");
+        glBufferData(GL_ARRAY_BUFFER, dadosGPU.size()*sizeof(VerticeGPU<D>), dadosGPU.data(),
+                     opcoes.aoVivo ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+    }
+
+    // O "stride" é D+3 floats (D pos + 3 cor); em 2D o shader completa z = 0
+    // Atributo 0: Posição (começa no offset 0)
+    glVertexAttribPointer(0, D, GL_FLOAT, GL_FALSE, sizeof(VerticeGPU<D>), (void*)0);
+    glEnableVertexAttribArray(0);
+    // Atributo 1: Cor (começa no offset D floats)
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VerticeGPU<D>), (void*)offsetof(VerticeGPU<D>, cor));
+    glEnableVertexAttribArray(1);
+
+    // Só o 3D precisa de depth buffer; em 2D as linhas saem na ordem do buffer
+    if (D == 3) glEnable(GL_DEPTH_TEST);
+    else glDisable(GL_DEPTH_TEST);
+    const GLbitfield mascaraLimpeza = D == 3 ? GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT : GL_COLOR_BUFFER_BIT;
+
+    // 3. INSTRUMENTAÇÃO
+    // -----------------
+    Perfilador perfilador;
+    perfilador.contarEnvio(dadosGPU.size()*sizeof(VerticeGPU<D>));
+    int etapaInput = perfilador.etapaCPU("processInput");
+    int etapaMatrizes = perfilador.etapaCPU("matrizes");
+    int etapaDesenho = perfilador.etapaCPU("desenho");
+    int etapaSwap = perfilador.etapaCPU("swap");
+    int passeCena = perfilador.passeGPU("cena");
+    int passeHUD = perfilador.passeGPU("hud");
+
+    // Cena e HUD compilam juntos (ou saem do cache)
+    GerenciadorProgramas programas;
+    programas.iniciar(opcoes.cacheShaders);
+    int idCena = programas.adicionar("cena", vertexShaderSource, fragmentShaderSource);
+    int idBlocos = D == 2 && opcoes.blocos && !opcoes.aoVivo ? programas.adicionar("blocos", CacheBlocos2D::fonteVertice, CacheBlocos2D::fonteFragmento) : -1;
+    perfilador.registrarProgramas(programas);
+    if (!programas.compilarTodos()) {
+        programas.liberar();
+        glDeleteVertexArrays(1, &VAO); glDeleteBuffers(1, &VBO);
+        return -1;
+    }
+    std::cout << "Shaders: " << programas.vindosDoCache() << " programa(s) do cache, preparo em "
+              << programas.msPreparo() << " ms" << std::endl;
+    unsigned int prog = programas.programa(idCena);
+    unsigned int loc = glGetUniformLocation(prog, "transform");
+    perfilador.iniciarGPU();
+    CacheBlocos2D blocos;
+    if constexpr (D == 2) {
+        if (idBlocos >= 0) blocos.iniciar(dadosGPU.data(), nSegmentos, VAO, prog, loc, programas.programa(idBlocos));
+    }
+    const int BLOCOS_POR_FRAME = 2, BLOCOS_OCIOSO = 8;   // preenchimento do cache: interagindo / parado
+    RefinamentoProgressivo refinamento;
+    if (opcoes.orcamentoProgressivo > 0.0) refinamento.iniciar(D == 3, opcoes.orcamentoProgressivo);
+    glm::mat4 mvpAtual(1.0f);
+    size_t segmentosProgressivo = 0;   // desenhados pelo refinamento, para o relatório do benchmark
+    auto desenharFaixa = [&](int primeiro, int quantidade) {
+        glUseProgram(prog);
+        glBindVertexArray(VAO);
+        glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(mvpAtual));
+        glDrawArrays(GL_LINES, 2 * primeiro, 2 * quantidade);
+        perfilador.contarDesenho();
+        segmentosProgressivo += quantidade;
+    };
+    if (!opcoes.caminhoCSV.empty() && perfilador.abrirCSV(opcoes.caminhoCSV))
+        std::cout << "Gravando tempos por frame em " << opcoes.caminhoCSV << std::endl;
+    std::cout << "HUD (F1): frame=branco, processInput=vermelho, matrizes=verde, desenho=azul, swap=amarelo,"
+              << " gpu cena/hud=tons claros; barra=p50, marcas=p95/p99, escala=33 ms" << std::endl;
+    std::cout << "Botao direito: seleciona dois vasos e mostra o caminho entre eles" << std::endl;
+    if (D == 3)
+        std::cout << "3D: botao esquerdo arrasta (arcball), W/S/A/D orbitam, R/T giram na tela,"
+                  << " roda/Q/E aproximam, setas deslocam" << std::endl;
+    double ultimoTitulo = 0.0;
+    std::string tituloAtual = opcoes.tituloBase;
+    bool primeiroFrameMedido = false;
+    bool primeiroFrame = true;
+
+    // 4. SELEÇÃO DE DOIS VASOS: ancestral comum, comprimento e resistência do caminho
+    // -------------------------------------------------------------------------------
+    // Topologia, hemodinâmica e a tabela de saltos só são montadas no primeiro clique
+    ConsultaCaminhos consulta(arena);
+    bool consultaPronta = false;
+    int selecionados[2] = {-1, -1};
+    std::vector<int> destacados;
+    auto pintar = [&](int s, glm::vec3 cor) {
+        size_t i = (size_t)posicaoDoSegmento(s);
+        VerticeGPU<D>* v = &dadosGPU[i * 2];
+        v[0].cor = v[1].cor = cor;
+        blocos.invalidar();
+        refinamento.reiniciar();
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferSubData(GL_ARRAY_BUFFER, i * 2 * sizeof(VerticeGPU<D>), 2 * sizeof(VerticeGPU<D>), v);
+        perfilador.contarEnvio(2 * sizeof(VerticeGPU<D>));
+    };
+    auto selecionar = [&](const glm::mat4& mvp, int larguraJanela, int alturaJanela) {
+        int melhor = -1;
+        float menor = 0.0f;
+        if (D == 3) {
+            // Perspectiva: projeta cada segmento na tela e mede em pixels até o clique
+            glm::vec3 clique((float)cliqueX, (float)cliqueY, 0.0f);
+            auto naTela = [&](const glm::vec4& c) {
+                return glm::vec3((0.5f + 0.5f * c.x / c.w) * larguraJanela, (0.5f - 0.5f * c.y / c.w) * alturaJanela, 0.0f);
+            };
+            for (int i = 0; i < segmentosVisiveis; i++) {
+                int s = segmentoNaPosicao(i);
+                const Segmento& seg = minhaArvore.segmentos[s];
+                glm::vec4 a = mvp * glm::vec4(minhaArvore.vertices[seg.indicePontoA].posicao, 1.0f);
+                glm::vec4 b = mvp * glm::vec4(minhaArvore.vertices[seg.indicePontoB].posicao, 1.0f);
+                if (a.w <= 0.0f || b.w <= 0.0f) continue;   // atrás da câmera
+                float d = GradeSegmentos::distanciaPontoSegmento(clique, naTela(a), naTela(b));
+                if (melhor < 0 || d < menor) { melhor = s; menor = d; }
+            }
+        } else {
+            glm::vec4 ndc(2.0f * (float)cliqueX / larguraJanela - 1.0f, 1.0f - 2.0f * (float)cliqueY / alturaJanela, 0.0f, 1.0f);
+            glm::vec4 mundo = glm::inverse(mvp) * ndc;
+            glm::vec3 p(mundo.x, mundo.y, 0.0f);
+            for (int i = 0; i < segmentosVisiveis; i++) {
+                int s = segmentoNaPosicao(i);
+                const Segmento& seg = minhaArvore.segmentos[s];
+                glm::vec3 a = minhaArvore.vertices[seg.indicePontoA].posicao, b = minhaArvore.vertices[seg.indicePontoB].posicao;
+                float d = GradeSegmentos::distanciaPontoSegmento(p, glm::vec3(a.x, a.y, 0.0f), glm::vec3(b.x, b.y, 0.0f));
+                if (melhor < 0 || d < menor) { melhor = s; menor = d; }
+            }
+        }
+        if (melhor < 0) return;
+
+        for (int s : destacados) pintar(s, minhaArvore.segmentos[s].cor);
+        destacados.clear();
+        int k = selecionados[0] < 0 || selecionados[1] >= 0 ? 0 : 1;
+        selecionados[k] = melhor;
+        if (k == 0) selecionados[1] = -1;
+        if (k == 1) {
+            if (!consultaPronta) {
+                PoolTarefas pool;
+                Topologia topo = montarTopologia(minhaArvore, pool);
+                Hemodinamica h = resolverHemodinamica(minhaArvore, topo, ParametrosHemodinamica(), pool);
+                consulta.montar(minhaArvore, topo, &h.resistencia, pool);
+                consultaPronta = true;
+            }
+            ConsultaCaminhos::Caminho c = consulta.caminho(selecionados[0], selecionados[1]);
+            if (c.ancestral < 0) {
+                std::cout << "Vasos " << indiceArquivo(selecionados[0]) << " e " << indiceArquivo(selecionados[1])
+                          << " estao em arvores diferentes" << std::endl;
+            } else {
+                std::cout << "Vasos " << indiceArquivo(selecionados[0]) << " e " << indiceArquivo(selecionados[1])
+                          << ": ancestral comum " << indiceArquivo(c.ancestral)
+                          << ", " << c.segmentos << " segmentos, comprimento " << c.comprimento
+                          << ", resistencia " << c.resistencia << " Pa.s/m^3" << std::endl;
+                consulta.segmentosDoCaminho(selecionados[0], selecionados[1], destacados);
             }
-        } else if (estadoAtual == "CELL_DATA") {
-            std::stringstream ss_l(linha); float r; ss_l >> r;
-            if (indiceRaioAtual < arvore.segmentos.size()) arvore.segmentos[indiceRaioAtual++].raio = r;
+        } else {
+            std::cout << "Vaso " << indiceArquivo(melhor) << " selecionado (raio " << minhaArvore.segmentos[melhor].raio << ")" << std::endl;
+            destacados.push_back(melhor);
         }
+        for (int s : destacados) pintar(s, glm::vec3(1.0f));
+    };
+
+    // Benchmark: histórico completo, HUD desligado e câmera no caminho roteirizado
+    Enquadramento enquadramento = enquadrarArvore(minhaArvore);
+    modo3D = D == 3;
+    if (modo3D) camera3D.enquadrar(enquadramento.centro, enquadramento.raio);
+    DadosBench dadosBench;
+    dadosBench.segmentos = minhaArvore.segmentos.size();
+    dadosBench.bytesCarga = perfilador.totalBytesEnviados();
+    double inicioBench = glfwGetTime();
+    if (opcoes.modoBench) {
+        perfilador.manterHistorico(true);
+        hudVisivel = false;
+        std::cout << "Benchmark: " << opcoes.bench.frames << " frames, caminho " << nomeCaminhoCamera(opcoes.bench.caminho) << std::endl;
     }
-    return arvore;
+
+    // 5. INGESTÃO AO VIVO
+    // -------------------
+    // Uma vez por frame, até MAX_REGISTROS_FRAME registros: um estado completo
+    // grande entra em alguns frames sem travar a janela. A árvore da CPU recebe
+    // tudo; o VBO só cresce (a capacidade dobra e o conteúdo é reenviado) e no
+    // resto dos frames recebe uma faixa contínua com os segmentos novos ou
+    // alterados. Ao vivo, o buffer fica na ordem dos segmentos.
+    const size_t MAX_REGISTROS_FRAME = 1 << 16;
+    std::vector<RegistroIngestao> registros;
+    std::vector<char> pontoMovido;
+    size_t capacidadeGPU = dadosGPU.size();   // vértices alocados no VBO
+    int passoAoVivo = -1;
+    bool reenquadrar = true;
+    auto drenarAoVivo = [&]() {
+        registros.resize(MAX_REGISTROS_FRAME);
+        size_t n = opcoes.aoVivo->drenar(registros.data(), registros.size());
+        if (n == 0) return false;
+        auto& vertices = minhaArvore.vertices;
+        auto& segmentos = minhaArvore.segmentos;
+        size_t sujoInicio = SIZE_MAX, sujoFim = 0;   // segmentos a reescrever no VBO
+        auto sujar = [&](size_t s) { sujoInicio = std::min(sujoInicio, s); sujoFim = std::max(sujoFim, s + 1); };
+        bool moveu = false;
+        int ignorados = 0, passoAnterior = passoAoVivo;
+        for (size_t k = 0; k < n; k++) {
+            const RegistroIngestao& r = registros[k];
+            switch (r.tipo) {
+            case REG_REINICIAR:
+                vertices.clear(); segmentos.clear(); dadosGPU.clear();
+                sujoInicio = SIZE_MAX; sujoFim = 0;
+                moveu = false; pontoMovido.clear();
+                selecionados[0] = selecionados[1] = -1;
+                destacados.clear();
+                reenquadrar = true;
+                break;
+            case REG_PONTO:
+                if (r.indice == vertices.size()) {
+                    vertices.push_back({glm::vec3(r.x, r.y, r.z)});
+                } else if (r.indice < vertices.size()) {
+                    vertices[r.indice].posicao = glm::vec3(r.x, r.y, r.z);
+                    if (pontoMovido.size() < vertices.size()) pontoMovido.resize(vertices.size(), 0);
+                    pontoMovido[r.indice] = 1;
+                    moveu = true;
+                } else {
+                    ignorados++;
+                }
+                break;
+            case REG_SEGMENTO:
+                if (r.a >= vertices.size() || r.b >= vertices.size() || r.indice > segmentos.size()) { ignorados++; break; }
+                if (r.indice == segmentos.size()) {
+                    // Cor nova como no carregador; a dos existentes fica (inclusive o destaque)
+                    glm::vec3 cor((rand() % 100) / 100.0f, (rand() % 100) / 100.0f, (rand() % 100) / 100.0f);
+                    segmentos.push_back({(int)r.a, (int)r.b, r.raio, cor});
+                    dadosGPU.push_back({glm::vec<D, float>(0.0f), cor});
+                    dadosGPU.push_back({glm::vec<D, float>(0.0f), cor});
+                } else {
+                    Segmento& s = segmentos[r.indice];
+                    s.indicePontoA = (int)r.a; s.indicePontoB = (int)r.b; s.raio = r.raio;
+                }
+                sujar(r.indice);
+                break;
+            case REG_RAIO:
+                if (r.indice < segmentos.size()) segmentos[r.indice].raio = r.raio;
+                else ignorados++;
+                break;
+            case REG_PASSO:
+                passoAoVivo = (int)r.indice;
+                break;
+            default:
+                ignorados++;
+            }
+        }
+        // Ponto movido: reescreve quem o usa (uma varredura por frame, só se houve)
+        if (moveu) {
+            pontoMovido.resize(vertices.size(), 0);
+            for (size_t s = 0; s < segmentos.size(); s++)
+                if (pontoMovido[segmentos[s].indicePontoA] || pontoMovido[segmentos[s].indicePontoB]) sujar(s);
+            std::fill(pontoMovido.begin(), pontoMovido.end(), 0);
+        }
+        for (size_t s = sujoInicio; s < sujoFim; s++) {
+            dadosGPU[s * 2].posicao = glm::vec<D, float>(vertices[segmentos[s].indicePontoA].posicao);
+            dadosGPU[s * 2 + 1].posicao = glm::vec<D, float>(vertices[segmentos[s].indicePontoB].posicao);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        if (dadosGPU.size() > capacidadeGPU) {
+            capacidadeGPU = std::max({dadosGPU.size(), 2 * capacidadeGPU, (size_t)4096});
+            glBufferData(GL_ARRAY_BUFFER, capacidadeGPU * sizeof(VerticeGPU<D>), nullptr, GL_DYNAMIC_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, dadosGPU.size() * sizeof(VerticeGPU<D>), dadosGPU.data());
+            perfilador.contarEnvio(dadosGPU.size() * sizeof(VerticeGPU<D>));
+        } else if (sujoFim > sujoInicio) {
+            size_t bytes = (sujoFim - sujoInicio) * 2 * sizeof(VerticeGPU<D>);
+            glBufferSubData(GL_ARRAY_BUFFER, sujoInicio * 2 * sizeof(VerticeGPU<D>), bytes, &dadosGPU[sujoInicio * 2]);
+            perfilador.contarEnvio(bytes);
+        }
+
+        // K/J no máximo acompanha o crescimento; a seleção é refeita no próximo clique
+        bool seguindo = segmentosVisiveis >= totalSegmentos;
+        totalSegmentos = (int)segmentos.size();
+        segmentosVisiveis = seguindo ? totalSegmentos : std::min(segmentosVisiveis, totalSegmentos);
+        consultaPronta = false;
+        refinamento.reiniciar();
+        if (reenquadrar && !vertices.empty()) {
+            reenquadrar = false;
+            enquadramento = enquadrarArvore(minhaArvore);
+            if (D == 3) camera3D.enquadrar(enquadramento.centro, enquadramento.raio);
+            else { cameraPos = enquadramento.centro; zoomLevel = 0.9f / enquadramento.raio; anguloRotacao = 0.0f; }
+        }
+        if (ignorados > 0) std::cerr << "ERRO: " << ignorados << " registro(s) do anel fora de ordem ignorados" << std::endl;
+        if (passoAoVivo != passoAnterior) {
+            tituloAtual = opcoes.tituloBase + " | passo " + std::to_string(passoAoVivo);
+            if (!hudVisivel) glfwSetWindowTitle(window, tituloAtual.c_str());
+        }
+        return true;
+    };
+
+    // Ritmo: com tecla segura ou arrasto o loop desenha a cada vsync; se o frame
+    // não cabe no intervalo de atualização, o vsync sai enquanto durar a
+    // interação (melhor rasgar que cair para metade do fps) e volta no repouso
+    const double ESPERA_OCIOSA = 0.5;   // s; rede de segurança, tudo o que muda a cena já gera evento
+    const double ESPERA_AO_VIVO = 1.0 / 120.0;   // s; o anel não gera evento, então o ócio o consulta
+    double periodoTela = 1.0 / 60.0;
+    if (const GLFWvidmode* modo = glfwGetVideoMode(glfwGetPrimaryMonitor()))
+        if (modo->refreshRate > 0) periodoTela = 1.0 / modo->refreshRate;
+    bool vsyncLigado = !opcoes.modoBench;
+    double ultimoSwap = 0.0;
+    bool interagindo = false;
+    double ultimaEntrada = glfwGetTime();
+
+    while (!glfwWindowShouldClose(window)) {
+        if (opcoes.modoBench && perfilador.framesMedidos() >= opcoes.bench.frames) break;
+
+        double inicioEntrada = glfwGetTime();
+        // Passo de tempo real, limitado para um engasgo (ex.: arrastar a janela) não virar um salto
+        float dt = (float)std::min(inicioEntrada - ultimaEntrada, 0.1);
+        ultimaEntrada = inicioEntrada;
+        if (!opcoes.modoBench) {
+            interagindo = processInput(window, dt) || arrastando;
+            if (interagindo) precisaDesenhar = true;
+            else if (!vsyncLigado) { glfwSwapInterval(1); vsyncLigado = true; }
+        }
+        if (opcoes.aoVivo && opcoes.aoVivo->pendentes() > 0) precisaDesenhar = true;
+        if (!opcoes.modoBench && !opcoes.continuo && !precisaDesenhar && blocos.pendentes()) {
+            // Parado, mas ainda há blocos em volta da vista para preencher: sem dormir
+            blocos.preencher(BLOCOS_OCIOSO);
+            glfwPollEvents();
+            continue;
+        }
+        if (!opcoes.modoBench && !opcoes.continuo && !precisaDesenhar) {
+            RASTREIO_ESCOPO("ocioso");
+            glfwWaitEventsTimeout(opcoes.aoVivo ? ESPERA_AO_VIVO : ESPERA_OCIOSA);
+            ultimaEntrada = glfwGetTime();   // o tempo parado não conta como movimento
+            continue;
+        }
+        precisaDesenhar = false;
+        double msEntrada = (glfwGetTime() - inicioEntrada) * 1000.0;
+
+        RASTREIO_ESCOPO(primeiroFrame ? "primeiro frame" : "frame");
+        primeiroFrame = false;
+        perfilador.inicioFrame();
+        if (opcoes.modoBench) {
+            TemporizadorCPU t(perfilador, etapaInput);
+            float progresso = opcoes.bench.frames > 1 ? (float)(perfilador.framesMedidos() - 1) / (opcoes.bench.frames - 1) : 0.0f;
+            if (D == 3) posicionarCamera3D(opcoes.bench.caminho, std::min(progresso, 1.0f), enquadramento, camera3D);
+            else posicionarCamera(opcoes.bench.caminho, std::min(progresso, 1.0f), enquadramento, cameraPos, zoomLevel, anguloRotacao);
+        } else {
+            perfilador.registrarCPU(etapaInput, msEntrada);
+        }
+
+        if (opcoes.aoVivo) {
+            RASTREIO_ESCOPO("ingestao");
+            if (drenarAoVivo() && opcoes.aoVivo->pendentes() > 0) precisaDesenhar = true;
+        }
+
+        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        glClear(mascaraLimpeza);
+
+        int w, h; glfwGetFramebufferSize(window, &w, &h);
+        glm::mat4 mvp;
+        {
+            TemporizadorCPU t(perfilador, etapaMatrizes);
+            float asp = (float)w/h;
+            if (D == 3) {
+                mvp = camera3D.projecao(asp) * camera3D.visao();
+            } else {
+                glm::mat4 proj = glm::ortho(-asp, asp, -1.0f, 1.0f, -1.0f, 1.0f);
+                glm::mat4 model = glm::mat4(1.0f);
+                model = glm::scale(model, glm::vec3(zoomLevel));
+                model = glm::translate(model, -cameraPos);      
+                model = glm::rotate(model, glm::radians(anguloRotacao), glm::vec3(0,0,1));
+                mvp = proj * model;
+            }
+        }
+
+        if (cliquePendente) {
+            cliquePendente = false;
+            int larguraJanela, alturaJanela;
+            glfwGetWindowSize(window, &larguraJanela, &alturaJanela);
+            if (larguraJanela > 0 && alturaJanela > 0) selecionar(mvp, larguraJanela, alturaJanela);
+        }
+
+        {
+            TemporizadorCPU t(perfilador, etapaDesenho);
+            perfilador.inicioGPU(passeCena);
+            // Em movimento, o 2D com cache só compõe blocos; parado, desenho exato
+            bool cacheOk = blocos.pronto() && blocos.agendar(mvp, w, h, segmentosVisiveis);
+            if (cacheOk && (interagindo || opcoes.modoBench)) {
+                size_t chamadasAntes = blocos.chamadasDesenho();
+                blocos.preencher(BLOCOS_POR_FRAME);
+                blocos.compor(mvp);
+                perfilador.contarDesenho((int)(blocos.chamadasDesenho() - chamadasAntes));
+                if (opcoes.modoBench) dadosBench.framesBlocos++;
+                if (blocos.blocosFaltando() > 0) precisaDesenhar = true;
+            } else if (opcoes.orcamentoProgressivo > 0.0) {
+                // Lote dentro do orçamento; parado, o loop continua até a imagem fechar
+                mvpAtual = mvp;
+                if (refinamento.desenhar(mvp, w, h, segmentosVisiveis, desenharFaixa)) precisaDesenhar = true;
+            } else {
+                glUseProgram(prog);
+                glBindVertexArray(VAO);
+                glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(mvp));
+                glDrawArrays(GL_LINES, 0, segmentosVisiveis * 2);
+                perfilador.contarDesenho();
+            }
+            perfilador.fimGPU(passeCena);
+
+            if (hudVisivel) {
+                perfilador.inicioGPU(passeHUD);
+                perfilador.desenharHUD(w, h);
+                perfilador.fimGPU(passeHUD);
+            }
+        }
+
+        {
+            TemporizadorCPU t(perfilador, etapaSwap);
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+        }
+        if (opcoes.inicioPrograma && !primeiroFrameMedido) {
+            primeiroFrameMedido = true;
+            glFinish();   // só no primeiro: o swap volta antes de a GPU terminar
+            std::cout << "Tempo ate o primeiro frame: " << (rastreio::agoraUs() - opcoes.inicioPrograma) / 1000.0
+                      << " ms" << std::endl;
+        }
+        perfilador.fimFrame();
+        double agora = glfwGetTime();
+        if (interagindo && vsyncLigado && ultimoSwap > 0.0 && agora - ultimoSwap > 1.5 * periodoTela) {
+            glfwSwapInterval(0);
+            vsyncLigado = false;
+        }
+        ultimoSwap = interagindo ? agora : 0.0;
+
+        // Percentis no título, sem pesar no frame
+        if (hudVisivel && glfwGetTime() - ultimoTitulo > 0.5) {
+            std::string titulo = tituloAtual + " | " + perfilador.resumo();
+            glfwSetWindowTitle(window, titulo.c_str());
+            ultimoTitulo = glfwGetTime();
+        } else if (!hudVisivel && ultimoTitulo > 0.0) {
+            glfwSetWindowTitle(window, tituloAtual.c_str());
+            ultimoTitulo = 0.0;
+        }
+    }
+
+    if (opcoes.modoBench) {
+        perfilador.finalizarGPU();
+        dadosBench.segundos = glfwGetTime() - inicioBench;
+        dadosBench.desenhos = perfilador.totalDesenhos();
+        dadosBench.bytesFrames = perfilador.totalBytesEnviados() - dadosBench.bytesCarga;
+        ConfigBench cfg = opcoes.bench;
+        if (blocos.pronto()) cfg.renderizador = "blocos";
+        if (opcoes.orcamentoProgressivo > 0.0) {
+            // Com blocos, o refinamento só desenha quando a vista não cabe no cache
+            cfg.renderizador = blocos.pronto() ? "blocos+progressivo" : "progressivo";
+            dadosBench.segmentosProgressivo = segmentosProgressivo;
+            dadosBench.loteProgressivo = refinamento.lote();
+            dadosBench.desenhadosProgressivo = refinamento.desenhados();
+        }
+        std::string relatorio = relatorioBench(cfg, dadosBench, perfilador, passeCena);
+        std::cout << relatorio;
+        if (!opcoes.caminhoRelatorio.empty()) {
+            std::ofstream f(opcoes.caminhoRelatorio);
+            f << relatorio;
+        }
+    }
+
+    perfilador.liberarGPU();
+    blocos.liberar();
+    refinamento.liberar();
+    glDeleteVertexArrays(1, &VAO); glDeleteBuffers(1, &VBO);
+    programas.liberar();
+    return 0;
 }
 
-unsigned int setupShaders() {
-    unsigned int v = glCreateShader(GL_VERTEX_SHADER); glShaderSource(v, 1, &vertexShaderSource, NULL); glCompileShader(v);
-    unsigned int f = glCreateShader(GL_FRAGMENT_SHADER); glShaderSource(f, 1, &fragmentShaderSource, NULL); glCompileShader(f);
-    unsigned int p = glCreateProgram(); glAttachShader(p, v); glAttachShader(p, f); glLinkProgram(p);
-    glDeleteShader(v); glDeleteShader(f); return p;
+// --- CARGA EM SEGUNDO PLANO ---
+// Leitura, reordenação, cores e montagem dos vértices não precisam do contexto
+// GL: rodam numa thread enquanto a principal cria a janela e o contexto, que
+// depois só espera (join) e envia o buffer.
+struct CargaArvore {
+    std::unique_ptr<ArenaArvore> arena;   // declarada antes: é destruída por último
+    std::optional<Arvore2D> arvore;
+    PermutacaoArvore permutacao;
+    int dimensao = 2;
+    std::unique_ptr<CenaCPU<2>> cena2D;
+    std::unique_ptr<CenaCPU<3>> cena3D;
+    double msCarga = 0.0;
+};
+
+void carregarEmSegundoPlano(const std::string& caminhoArquivo, bool morton, const std::string& colorir, bool ordenarPorRaio,
+                            CargaArvore& carga) {
+    rastreio::nomearThread("carga");
+    uint64_t inicio = rastreio::agoraUs();
+    // Árvore e tudo o que deriva dela numa arena só, liberada de uma vez na saída
+    std::error_code erroTamanho;
+    uintmax_t tamanhoArquivo = std::filesystem::file_size(caminhoArquivo, erroTamanho);
+    carga.arena = std::make_unique<ArenaArvore>(erroTamanho ? RecursoPaginasGrandes::PAGINA : (size_t)tamanhoArquivo);
+    Arvore2D& minhaArvore = carga.arvore.emplace(carregarArvore(caminhoArquivo, carga.arena->recurso()));
+    if (minhaArvore.vertices.empty()) return;
+
+    if (morton) carga.permutacao = reordenarMorton(minhaArvore);
+
+    if (colorir == "profundidade" || colorir == "strahler") {
+        Topologia topo = montarTopologia(minhaArvore);
+        const std::pmr::vector<int>& v = colorir == "strahler" ? topo.strahler : topo.profundidade;
+        colorirPorCampo(minhaArvore, std::vector<float>(v.begin(), v.end()), false);
+        std::cout << topo.raizes.size() << " raiz(es), " << topo.nNiveis() << " niveis" << std::endl;
+    } else if (!colorir.empty()) {
+        Hemodinamica h = resolverHemodinamica(minhaArvore);
+        colorirPorCampo(minhaArvore, colorir == "fluxo" ? h.fluxo : colorir == "pressao" ? h.pressaoDistal : h.resistencia);
+        std::cout << "Fluxo total " << h.fluxoTotal * 6e7 << " mL/min, volume " << h.volumeTotal * 1e6 << " cm^3" << std::endl;
+    }
+
+    // Dimensão detectada uma vez; o resto roda na instância especializada
+    carga.dimensao = detectarDimensao(minhaArvore);
+    if (carga.dimensao == 3) {
+        carga.cena3D = std::make_unique<CenaCPU<3>>(carga.arena->recurso());
+        montarCena<3>(minhaArvore, *carga.cena3D, true);
+    } else {
+        carga.cena2D = std::make_unique<CenaCPU<2>>(carga.arena->recurso());
+        montarCena<2>(minhaArvore, *carga.cena2D, ordenarPorRaio);
+    }
+    carga.msCarga = (rastreio::agoraUs() - inicio) / 1000.0;
+}
+
+// Modo ao vivo: espera o produtor criar o anel e começa com a árvore vazia, na
+// dimensão que ele anunciou; o resto chega pelo anel, já com a janela aberta.
+// Desiste depois de ESPERA_ANEL_S ou quando 'cancelar' liga (janela fechada);
+// nesses casos a árvore fica sem valor.
+void conectarAoVivo(const std::string& nomeAnel, AnelIngestao& anel, CargaArvore& carga, const std::atomic<bool>& cancelar) {
+    const double ESPERA_ANEL_S = 60.0;
+    rastreio::nomearThread("carga");
+    uint64_t inicio = rastreio::agoraUs();
+    bool avisou = false;
+    while (!anel.abrir(nomeAnel)) {
+        if (cancelar.load(std::memory_order_relaxed)) return;
+        if ((rastreio::agoraUs() - inicio) / 1e6 > ESPERA_ANEL_S) {
+            std::cerr << "ERRO: o anel " << nomeAnel << " nao apareceu em " << ESPERA_ANEL_S << " s" << std::endl;
+            return;
+        }
+        if (!avisou) std::cout << "Esperando o produtor criar o anel " << nomeAnel << "..." << std::endl;
+        avisou = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    // Sem arena: a árvore e a cena crescem, encolhem e recomeçam a cada REINICIAR,
+    // e o que a arena monotônica soltasse nunca voltaria. Ficam no heap.
+    carga.arvore.emplace();
+    carga.dimensao = anel.dimensao() == 3 ? 3 : 2;
+    if (carga.dimensao == 3) carga.cena3D = std::make_unique<CenaCPU<3>>(std::pmr::get_default_resource());
+    else carga.cena2D = std::make_unique<CenaCPU<2>>(std::pmr::get_default_resource());
+    carga.msCarga = (rastreio::agoraUs() - inicio) / 1000.0;
 }
 
 // --- MAIN COM ARGUMENTOS (argc, argv) ---
 int main(int argc, char* argv[]) {
-    // Verificar se o usuário passou um arquivo
-    std::string caminhoArquivo;
-    if (argc > 1) {
-        int tamanhoArvore = atoi(argv[2]);
-        int step = atoi(argv[3]);
-        char caminhoBuilder[90] = "";
-        char aux[10];
- 
-        switch (atoi(argv[1]))
-        {
-        case 2:
-            std::cout << "Tentando carregar árvore 2D de " << tamanhoArvore << " termos, no step " << step << std::endl;
-            strcat(caminhoBuilder, "../TP_CCO_Pacote_Dados/TP_CCO_Pacote_Dados/TP1_2D/Nterm_");
-            if (tamanhoArvore != 64 && tamanhoArvore != 128 && tamanhoArvore != 256) {
-                std::cout << "Tamanho de árvore inválido, tente algum desses valores: [64, 128, 256]" << std::endl;
+    uint64_t inicioPrograma = rastreio::agoraUs();
+    // Opções "--xxx" podem vir em qualquer posição; o resto são argumentos posicionais
+    std::vector<std::string> posicionais;
+    std::string caminhoCSV;
+    bool modoBench = false;
+    ConfigBench bench;
+    std::string caminhoRelatorio;
+    bool morton = false;   // reordena vértices e segmentos pela curva Z depois de carregar
+    bool continuo = false; // desenha todo frame mesmo sem mudança (para medir com o HUD)
+    std::string cacheShaders = diretorioCache().empty() ? "" : diretorioCache() + "/shaders";
+    std::vector<std::string> raizesDados;   // onde o catálogo procura árvores
+    std::string caminhoIndice = diretorioCache().empty() ? "" : diretorioCache() + "/catalogo.tsv";
+    bool listar = false;
+    bool blocos = false;   // 2D: cache de blocos em textura para pan/zoom
+    double orcamentoProgressivo = 0.0;   // ms de GPU por frame no refinamento progressivo (0 = desligado)
+    bool medirInicio = false;   // imprime carga, janela e tempo até o primeiro frame
+    std::string nomeAnel;   // --ao-vivo: anel de ingestão no lugar de um arquivo
+    std::string colorir;   // fluxo, pressao, resistencia, profundidade ou strahler (vazio = cores aleatórias)
+    // O rastreio é gravado em qualquer saída de main, inclusive nos retornos de erro
+    struct GravarRastreio { ~GravarRastreio() { rastreio::gravar(); } } gravarNoFim;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--hud") hudVisivel = true;
+        else if (arg == "--perfil-csv" && i + 1 < argc) caminhoCSV = argv[++i];
+        else if (arg == "--trace" && i + 1 < argc) rastreio::ativar(argv[++i]);
+        else if (arg == "--bench" && i + 1 < argc) { modoBench = true; bench.arquivo = argv[++i]; }
+        else if (arg == "--frames" && i + 1 < argc) bench.frames = std::max(1, atoi(argv[++i]));
+        else if (arg == "--bench-saida" && i + 1 < argc) caminhoRelatorio = argv[++i];
+        else if (arg == "--morton") morton = true;
+        else if (arg == "--continuo") continuo = true;
+        else if (arg == "--cache-shaders" && i + 1 < argc) cacheShaders = argv[++i];
+        else if (arg == "--sem-cache-shaders") cacheShaders.clear();
+        else if (arg == "--tempo-inicio") medirInicio = true;
+        else if (arg == "--dados" && i + 1 < argc) raizesDados.push_back(argv[++i]);
+        else if (arg == "--indice" && i + 1 < argc) caminhoIndice = argv[++i];
+        else if (arg == "--listar") listar = true;
+        else if (arg == "--blocos") blocos = true;
+        else if (arg == "--ao-vivo" && i + 1 < argc) nomeAnel = argv[++i];
+        else if (arg == "--progressivo" && i + 1 < argc) orcamentoProgressivo = std::max(0.5, atof(argv[++i]));
+        else if (arg == "--colorir" && i + 1 < argc) {
+            colorir = argv[++i];
+            if (colorir != "fluxo" && colorir != "pressao" && colorir != "resistencia" &&
+                colorir != "profundidade" && colorir != "strahler") {
+                std::cout << "Campo invalido para --colorir, use fluxo, pressao, resistencia, profundidade ou strahler" << std::endl;
                 return 1;
             }
-            sprintf(aux,"%03d",tamanhoArvore);
-            strcat(caminhoBuilder, aux);
-            strcat(caminhoBuilder, "/tree2D_Nterm");
-            sprintf(aux,"%04d",tamanhoArvore);
-            strcat(caminhoBuilder, aux);
-            strcat(caminhoBuilder, "_step");
-            sprintf(aux,"%04d", step);
-            strcat(caminhoBuilder, aux);
-            strcat(caminhoBuilder, ".vtk");
- 
-            caminhoArquivo = caminhoBuilder;
-            break;
- 
-        case 3:
-            std::cout << "3D ainda não implementado" << std::endl;
-            std::cout << "Carregando arquivo padrao..." << std::endl;
-            caminhoArquivo = "../TP_CCO_Pacote_Dados/TP_CCO_Pacote_Dados/TP1_2D/Nterm_256/tree2D_Nterm0256_step0224.vtk";
-            break;
- 
-        default:
+        }
+        else if (arg == "--path" && i + 1 < argc) {
+            if (!lerCaminhoCamera(argv[++i], bench.caminho)) {
+                std::cout << "Caminho de camera invalido, use orbit, zoom ou pan" << std::endl;
+                return 1;
+            }
+        }
+        else posicionais.push_back(arg);
+    }
+    rastreio::ativarPorAmbiente();
+
+    // Verificar se o usuário passou um arquivo
+    std::string caminhoArquivo;
+    if (modoBench) {
+        caminhoArquivo = bench.arquivo;
+    }
+    else if (!nomeAnel.empty()) {
+        caminhoArquivo = "ao vivo: " + nomeAnel;
+        if (blocos) std::cout << "--blocos nao vale no modo ao vivo (a arvore muda a todo passo)" << std::endl;
+        blocos = false;
+    }
+    else if (posicionais.size() >= 3 || listar) {
+        // Catálogo das raízes de dados: com o índice em dia, só stat nos arquivos
+        if (raizesDados.empty()) raizesDados.push_back("../TP_CCO_Pacote_Dados");
+        Catalogo catalogo;
+        catalogo.carregarIndice(caminhoIndice);
+        int relidos = catalogo.atualizar(raizesDados);
+        if (relidos > 0 && !caminhoIndice.empty()) catalogo.salvarIndice(caminhoIndice);
+        if (listar) {
+            catalogo.listar(std::cout);
+            return 0;
+        }
+
+        int dimensao = atoi(posicionais[0].c_str());
+        int tamanhoArvore = atoi(posicionais[1].c_str());
+        int step = atoi(posicionais[2].c_str());
+        if (dimensao != 2 && dimensao != 3) {
             std::cout << "Opção inválida de dimensões, tente '2' para 2D ou '3' para 3D" << std::endl;
             return 1;
-            break;
         }
+        std::cout << "Tentando carregar árvore " << dimensao << "D de " << tamanhoArvore << " termos, no step " << step << std::endl;
+        const EntradaCatalogo* entrada = catalogo.procurar(dimensao, tamanhoArvore, step);
+        if (!entrada) {
+            std::vector<int> disponiveis = catalogo.nTerms(dimensao);
+            if (std::find(disponiveis.begin(), disponiveis.end(), tamanhoArvore) == disponiveis.end()) {
+                std::cout << "Tamanho de árvore inválido, tente algum desses valores: [";
+                for (size_t k = 0; k < disponiveis.size(); k++) std::cout << (k ? ", " : "") << disponiveis[k];
+                std::cout << "]" << std::endl;
+            } else {
+                std::cout << "Step " << step << " nao encontrado para Nterm " << tamanhoArvore << " (veja --listar)" << std::endl;
+            }
+            return 1;
+        }
+        caminhoArquivo = entrada->caminho;
+        const ResumoArvore& r = entrada->resumo;
+        std::cout << r.nPontos << " pontos, " << r.nSegmentos << " segmentos, raio em [" << r.raioMin << ", " << r.raioMax << "]" << std::endl;
     }
     else {
-        std::cout << "Uso: ./meu_app <nDimensoes> <Nterm> <step>" << std::endl;
+        std::cout << "Uso: ./meu_app <nDimensoes> <Nterm> <step> [--hud] [--perfil-csv <arquivo>] [--trace <arquivo.json>]"
+                  << " [--colorir fluxo|pressao|resistencia|profundidade|strahler] [--morton] [--continuo]"
+                  << " [--cache-shaders <dir>] [--sem-cache-shaders] [--tempo-inicio] [--blocos] [--progressivo <ms>]"
+                  << " [--dados <raiz>]... [--indice <arquivo>]" << std::endl;
+        std::cout << "     ./meu_app --listar [--dados <raiz>]..." << std::endl;
+        std::cout << "     ./meu_app --ao-vivo <anel> [--hud] [--progressivo <ms>] ...   (produtor: ./repetir_passos)" << std::endl;
+        std::cout << "     ./meu_app --bench <arquivo> [--path orbit|zoom|pan] [--frames N] [--bench-saida <arquivo.json>]" << std::endl;
         std::cout << "Carregando arquivo padrao..." << std::endl;
         // Caminho padrão (fallback)
         caminhoArquivo = "../TP_CCO_Pacote_Dados/TP_CCO_Pacote_Dados/TP1_2D/Nterm_256/tree2D_Nterm0256_step0224.vtk"; // Ajuste se necessário
     }
 
+    CargaArvore carga;
+    AnelIngestao anel;
+    std::thread threadCarga;
+    std::atomic<bool> cancelarCarga{false}, cargaTerminou{false};
+    if (nomeAnel.empty()) {
+        std::cout << "Tentando carregar: " << caminhoArquivo << std::endl;
+        threadCarga = std::thread(carregarEmSegundoPlano, std::cref(caminhoArquivo), morton, std::cref(colorir),
+                                  orcamentoProgressivo > 0.0, std::ref(carga));
+    } else {
+        threadCarga = std::thread([&]() {
+            conectarAoVivo(nomeAnel, anel, carga, cancelarCarga);
+            cargaTerminou.store(true, std::memory_order_release);
+        });
+    }
+
+    uint64_t inicioJanela = rastreio::agoraUs();
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
     GLFWwindow* window = glfwCreateWindow(800, 600, "Visualizador CCO", NULL, NULL);
-    if (!window) { glfwTerminate(); return -1; }
+    if (!window) { cancelarCarga = true; threadCarga.join(); glfwTerminate(); return -1; }
     glfwMakeContextCurrent(window);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) return -1;
-
-    std::cout << "Tentando carregar: " << caminhoArquivo << std::endl;
-    Arvore2D minhaArvore = carregarVTK(caminhoArquivo);
-    
-    if (minhaArvore.vertices.empty()) { 
+    glfwSetWindowRefreshCallback(window, window_refresh_callback);
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
+    glfwSetCursorPosCallback(window, cursor_pos_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) { cancelarCarga = true; threadCarga.join(); glfwTerminate(); return -1; }
+    if (modoBench) glfwSwapInterval(0);   // sem vsync: mede o custo real do frame
+    uint64_t fimJanela = rastreio::agoraUs();
+    rastreio::completo("criar janela e contexto", inicioJanela, fimJanela);
+
+    {
+        RASTREIO_ESCOPO("esperar carga");
+        // Ao vivo, o produtor pode demorar: a janela segue respondendo e fechá-la desiste
+        while (!nomeAnel.empty() && !cargaTerminou.load(std::memory_order_acquire)) {
+            glfwWaitEventsTimeout(0.1);
+            if (glfwWindowShouldClose(window)) cancelarCarga = true;
+        }
+        threadCarga.join();
+    }
+    if (cancelarCarga) { glfwTerminate(); return 0; }
+    if (medirInicio)
+        std::cout << "Carga " << carga.msCarga << " ms em paralelo com janela " << (fimJanela - inicioJanela) / 1000.0
+                  << " ms; espera no join " << (rastreio::agoraUs() - fimJanela) / 1000.0 << " ms" << std::endl;
+    if (!carga.arvore || (carga.arvore->vertices.empty() && nomeAnel.empty())) {
         std::cerr << "Falha ao carregar a arvore! Verifique o caminho." << std::endl;
         glfwTerminate(); return -1; 
     }
+    Arvore2D& minhaArvore = *carga.arvore;
 
     totalSegmentos = minhaArvore.segmentos.size();
     segmentosVisiveis = totalSegmentos; 
     std::string tituloBase = "TP1 [" + caminhoArquivo + "]";
     glfwSetWindowTitle(window, tituloBase.c_str());
 
-    // 2. PREPARAR BUFFERS COM COR (Position + Color)
-    // ----------------------------------------------
-    std::vector<float> dadosGPU; // Agora contém X,Y,Z, R,G,B, X,Y,Z, R,G,B...
-    for (const auto& s : minhaArvore.segmentos) {
-        const auto& pA = minhaArvore.vertices[s.indicePontoA];
-        const auto& pB = minhaArvore.vertices[s.indicePontoB];
-        
-        // Vértice A (Posição + Cor do Segmento)
-        dadosGPU.push_back(pA.posicao.x); dadosGPU.push_back(pA.posicao.y); dadosGPU.push_back(pA.posicao.z);
-        dadosGPU.push_back(s.cor.r);      dadosGPU.push_back(s.cor.g);      dadosGPU.push_back(s.cor.b);
-
-        // Vértice B (Posição + Cor do Segmento)
-        dadosGPU.push_back(pB.posicao.x); dadosGPU.push_back(pB.posicao.y); dadosGPU.push_back(pB.posicao.z);
-        dadosGPU.push_back(s.cor.r);      dadosGPU.push_back(s.cor.g);      dadosGPU.push_back(s.cor.b);
-    }
-
-    unsigned int VBO, VAO;
-    glGenVertexArrays(1, &VAO); glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO); glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, dadosGPU.size()*sizeof(float), dadosGPU.data(), GL_STATIC_DRAW);
-
-    // Agora o "stride" é 6 floats (3 pos + 3 cor)
-    // Atributo 0: Posição (começa no offset 0)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6*sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // Atributo 1: Cor (começa no offset 3 floats)
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6*sizeof(float), (void*)(3*sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    unsigned int prog = setupShaders();
-    unsigned int loc = glGetUniformLocation(prog, "transform");
-
-    while (!glfwWindowShouldClose(window)) {
-        processInput(window);
-
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT); 
-
-        glUseProgram(prog);
-        glBindVertexArray(VAO);
-
-        int w, h; glfwGetFramebufferSize(window, &w, &h);
-        float asp = (float)w/h;
-        glm::mat4 proj = glm::ortho(-asp, asp, -1.0f, 1.0f, -1.0f, 1.0f);
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::scale(model, glm::vec3(zoomLevel));
-        model = glm::translate(model, -cameraPos);      
-        model = glm::rotate(model, glm::radians(anguloRotacao), glm::vec3(0,0,1));
-        
-        glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(proj * model));
-        glDrawArrays(GL_LINES, 0, segmentosVisiveis * 2);
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
+    // Dimensão detectada uma vez; o resto roda na instância especializada
+    OpcoesVisualizador opcoes;
+    opcoes.modoBench = modoBench;
+    opcoes.bench = bench;
+    opcoes.caminhoCSV = caminhoCSV;
+    opcoes.caminhoRelatorio = caminhoRelatorio;
+    opcoes.tituloBase = tituloBase;
+    opcoes.permutacao = &carga.permutacao;
+    opcoes.continuo = continuo;
+    opcoes.cacheShaders = cacheShaders;
+    if (medirInicio) opcoes.inicioPrograma = inicioPrograma;
+    opcoes.blocos = blocos;
+    opcoes.orcamentoProgressivo = orcamentoProgressivo;
+    if (anel.aberto()) opcoes.aoVivo = &anel;
+    std::cout << "Arvore " << carga.dimensao << "D" << std::endl;
+    if (carga.dimensao == 3) visualizar<3>(window, minhaArvore, *carga.cena3D, opcoes);
+    else visualizar<2>(window, minhaArvore, *carga.cena2D, opcoes);
 
-    glDeleteVertexArrays(1, &VAO); glDeleteBuffers(1, &VBO); glDeleteProgram(prog);
     glfwTerminate();
     return 0;
 }
\ No newline at end of file
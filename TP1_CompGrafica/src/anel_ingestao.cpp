@@ -0,0 +1,153 @@
+#include "anel_ingestao.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Só índices e flags: o mesmo layout nos dois processos, sem ponteiros
+struct AnelIngestao::Cabecalho {
+    std::atomic<uint32_t> magica;         // escrita por último: o resto já está pronto
+    uint32_t versao, capacidade;
+    int32_t dimensao;
+    alignas(64) std::atomic<uint64_t> escrita;        // só o produtor escreve
+    alignas(64) std::atomic<uint64_t> leitura;        // só o consumidor escreve
+    alignas(64) std::atomic<uint32_t> pedidoEstado;   // consumidor liga, produtor desliga
+};
+
+namespace {
+
+const uint32_t MAGICA = 0x4F564941;   // "AIVO"
+const uint32_t VERSAO = 1;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "o anel precisa de atômicos sem trava entre processos");
+static_assert(sizeof(RegistroIngestao) % alignof(RegistroIngestao) == 0, "registros contíguos");
+
+} // namespace
+
+bool AnelIngestao::mapear(int fd, size_t bytes) {
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) return false;
+    cabecalho = (Cabecalho*)p;
+    dados = (RegistroIngestao*)((char*)p + sizeof(Cabecalho));
+    bytesMapeados = bytes;
+    return true;
+}
+
+bool AnelIngestao::criar(const std::string& nome, int dimensao, uint32_t capacidade) {
+    fechar();
+    if (capacidade == 0 || (capacidade & (capacidade - 1)) != 0) return false;
+    size_t bytes = sizeof(Cabecalho) + (size_t)capacidade * sizeof(RegistroIngestao);
+    for (int tentativa = 0; tentativa < 2; tentativa++) {
+        int fd = shm_open(nome.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0) {
+            bool ok = ftruncate(fd, (off_t)bytes) == 0 && mapear(fd, bytes);
+            close(fd);
+            if (!ok) { shm_unlink(nome.c_str()); fechar(); return false; }
+            Cabecalho* c = new (cabecalho) Cabecalho();
+            c->versao = VERSAO;
+            c->capacidade = capacidade;
+            c->dimensao = dimensao;
+            c->escrita.store(0, std::memory_order_relaxed);
+            c->leitura.store(0, std::memory_order_relaxed);
+            c->pedidoEstado.store(0, std::memory_order_relaxed);
+            c->magica.store(MAGICA, std::memory_order_release);
+            mascara = capacidade - 1;
+            leituraVista = escritaVista = 0;
+            return true;
+        }
+        if (errno != EEXIST) return false;
+
+        // Já existe: reaproveita se for igual, senão remove e cria de novo
+        fd = shm_open(nome.c_str(), O_RDWR, 0600);
+        struct stat st;
+        if (fd >= 0 && fstat(fd, &st) == 0 && (size_t)st.st_size == bytes && mapear(fd, bytes)) {
+            close(fd);
+            if (cabecalho->magica.load(std::memory_order_acquire) == MAGICA && cabecalho->versao == VERSAO &&
+                cabecalho->capacidade == capacidade && cabecalho->dimensao == dimensao) {
+                mascara = capacidade - 1;
+                leituraVista = cabecalho->leitura.load(std::memory_order_acquire);
+                return true;
+            }
+            fechar();
+        } else if (fd >= 0) {
+            close(fd);
+        }
+        shm_unlink(nome.c_str());
+    }
+    return false;
+}
+
+bool AnelIngestao::abrir(const std::string& nome) {
+    fechar();
+    int fd = shm_open(nome.c_str(), O_RDWR, 0600);
+    if (fd < 0) return false;
+    struct stat st;
+    // O produtor pode estar entre o shm_open e o ftruncate, ou sem ter escrito a mágica
+    bool ok = fstat(fd, &st) == 0 && (size_t)st.st_size > sizeof(Cabecalho) && mapear(fd, (size_t)st.st_size);
+    close(fd);
+    if (!ok) return false;
+    uint32_t capacidade = cabecalho->capacidade;
+    if (cabecalho->magica.load(std::memory_order_acquire) != MAGICA || cabecalho->versao != VERSAO ||
+        bytesMapeados != sizeof(Cabecalho) + (size_t)capacidade * sizeof(RegistroIngestao)) {
+        fechar();
+        return false;
+    }
+    mascara = capacidade - 1;
+    // O que ficou no anel é de antes: começa do zero e pede o estado completo
+    escritaVista = cabecalho->escrita.load(std::memory_order_acquire);
+    cabecalho->leitura.store(escritaVista, std::memory_order_release);
+    cabecalho->pedidoEstado.store(1, std::memory_order_release);
+    return true;
+}
+
+void AnelIngestao::fechar() {
+    if (cabecalho) munmap(cabecalho, bytesMapeados);
+    cabecalho = nullptr;
+    dados = nullptr;
+    bytesMapeados = 0;
+}
+
+int AnelIngestao::dimensao() const {
+    return cabecalho ? cabecalho->dimensao : 0;
+}
+
+size_t AnelIngestao::publicar(const RegistroIngestao* registros, size_t n) {
+    const uint64_t capacidade = mascara + 1;
+    uint64_t escrita = cabecalho->escrita.load(std::memory_order_relaxed);
+    if (escrita + n - leituraVista > capacidade) leituraVista = cabecalho->leitura.load(std::memory_order_acquire);
+    size_t cabem = (size_t)std::min<uint64_t>(n, capacidade - (escrita - leituraVista));
+    size_t inicio = (size_t)(escrita & mascara);
+    size_t ate = std::min(cabem, (size_t)capacidade - inicio);
+    std::memcpy(dados + inicio, registros, ate * sizeof(RegistroIngestao));
+    std::memcpy(dados, registros + ate, (cabem - ate) * sizeof(RegistroIngestao));
+    cabecalho->escrita.store(escrita + cabem, std::memory_order_release);
+    return cabem;
+}
+
+bool AnelIngestao::estadoPedido() {
+    return cabecalho->pedidoEstado.load(std::memory_order_relaxed) != 0 &&
+           cabecalho->pedidoEstado.exchange(0, std::memory_order_acq_rel) != 0;
+}
+
+size_t AnelIngestao::drenar(RegistroIngestao* destino, size_t maximo) {
+    uint64_t leitura = cabecalho->leitura.load(std::memory_order_relaxed);
+    if (escritaVista - leitura < maximo) escritaVista = cabecalho->escrita.load(std::memory_order_acquire);
+    size_t n = (size_t)std::min<uint64_t>(maximo, escritaVista - leitura);
+    size_t inicio = (size_t)(leitura & mascara);
+    size_t ate = std::min(n, (size_t)(mascara + 1) - inicio);
+    std::memcpy(destino, dados + inicio, ate * sizeof(RegistroIngestao));
+    std::memcpy(destino + ate, dados, (n - ate) * sizeof(RegistroIngestao));
+    cabecalho->leitura.store(leitura + n, std::memory_order_release);
+    return n;
+}
+
+size_t AnelIngestao::pendentes() const {
+    return (size_t)(cabecalho->escrita.load(std::memory_order_acquire) - cabecalho->leitura.load(std::memory_order_relaxed));
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// --- ANEL DE INGESTÃO AO VIVO ---
+// Fila SPSC em memória compartilhada (shm_open) entre um produtor (simulação
+// CCO, repetir_passos) e o visualizador (--ao-vivo). O produtor escreve
+// registros de tamanho fixo e publica o índice de escrita; o visualizador
+// drena o que houver uma vez por frame. Sem trava e sem arquivo: cada lado só
+// escreve o próprio índice, e os dois ficam em linhas de cache separadas.
+//
+// Semântica dos registros, aplicados na ordem:
+//   PONTO     indice, x y z     acrescenta (indice == nPontos) ou move um ponto
+//   SEGMENTO  indice, a b raio  acrescenta (indice == nSegmentos) ou reescreve
+//   RAIO      indice, raio      só o raio de um segmento existente
+//   REINICIAR                   esvazia a árvore (começo de um estado completo)
+//   PASSO     indice            fim de um passo da simulação (só informativo)
+// Os pontos de um segmento precisam vir antes dele no anel.
+//
+// Quem abre como consumidor descarta o que estava pendente e pede o estado
+// completo; o produtor vê o pedido em estadoPedido() e manda REINICIAR + tudo.
+// Se o anel enche e ninguém drena, o produtor decide (esperar ou descartar e
+// reenviar o estado depois).
+
+enum TipoRegistro : uint32_t { REG_PONTO = 1, REG_SEGMENTO = 2, REG_RAIO = 3, REG_REINICIAR = 4, REG_PASSO = 5 };
+
+struct RegistroIngestao {
+    uint32_t tipo = 0, indice = 0;
+    uint32_t a = 0, b = 0;     // SEGMENTO
+    float x = 0.0f, y = 0.0f, z = 0.0f;   // PONTO
+    float raio = 0.0f;         // SEGMENTO, RAIO
+};
+static_assert(sizeof(RegistroIngestao) == 32, "registro do anel tem 32 bytes");
+
+class AnelIngestao {
+public:
+    static const uint32_t CAPACIDADE_PADRAO = 1u << 20;   // registros (32 MiB)
+
+    AnelIngestao() = default;
+    AnelIngestao(const AnelIngestao&) = delete;
+    AnelIngestao& operator=(const AnelIngestao&) = delete;
+    ~AnelIngestao() { fechar(); }
+
+    // Produtor: cria o anel 'nome' (ex.: "/cco_ao_vivo"). Um anel que já existe
+    // com a mesma capacidade e dimensão é reaproveitado (o visualizador pode
+    // continuar ligado nele); senão é recriado, e quem estava no antigo precisa
+    // reabrir. 'capacidade' é potência de 2.
+    bool criar(const std::string& nome, int dimensao, uint32_t capacidade = CAPACIDADE_PADRAO);
+    // Consumidor: abre um anel existente; false se o produtor ainda não o criou
+    bool abrir(const std::string& nome);
+    void fechar();
+    bool aberto() const { return cabecalho != nullptr; }
+    int dimensao() const;
+
+    // Produtor: publica até n registros, sem esperar; devolve quantos couberam
+    size_t publicar(const RegistroIngestao* registros, size_t n);
+    // Produtor: true uma vez depois de cada consumidor novo
+    bool estadoPedido();
+
+    // Consumidor: copia até 'maximo' registros para 'destino' e os libera no anel
+    size_t drenar(RegistroIngestao* destino, size_t maximo);
+    size_t pendentes() const;
+
+private:
+    struct Cabecalho;
+    bool mapear(int fd, size_t bytes);
+
+    Cabecalho* cabecalho = nullptr;
+    RegistroIngestao* dados = nullptr;
+    size_t bytesMapeados = 0;
+    uint64_t mascara = 0;
+    // Cópias locais do índice do outro lado: só relê a linha compartilhada
+    // quando a cópia diz que o anel está cheio (produtor) ou vazio (consumidor)
+    uint64_t leituraVista = 0, escritaVista = 0;
+};
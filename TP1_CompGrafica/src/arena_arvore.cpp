@@ -0,0 +1,51 @@
+#include "arena_arvore.h"
+
+#include <algorithm>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+size_t arredondarPagina(size_t bytes) {
+    const size_t p = RecursoPaginasGrandes::PAGINA;
+    return (std::max<size_t>(bytes, 1) + p - 1) / p * p;
+}
+
+} // namespace
+
+void* RecursoPaginasGrandes::do_allocate(size_t bytes, size_t alinhamento) {
+    size_t tamanho = arredondarPagina(bytes);
+#if defined(__linux__)
+    // mmap alinha a 4 KiB (2 MiB com HUGETLB); o monotônico nunca pede mais que isso
+    if (alinhamento > 4096) throw std::bad_alloc();
+    void* p = mmap(nullptr, tamanho, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p == MAP_FAILED) {
+        p = mmap(nullptr, tamanho, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc();
+#if defined(MADV_HUGEPAGE)
+        madvise(p, tamanho, MADV_HUGEPAGE);
+#endif
+    }
+#else
+    void* p = ::operator new(tamanho, std::align_val_t(std::max(alinhamento, alignof(std::max_align_t))));
+#endif
+    mapeados += tamanho;
+    return p;
+}
+
+void RecursoPaginasGrandes::do_deallocate(void* p, size_t bytes, size_t alinhamento) {
+    size_t tamanho = arredondarPagina(bytes);
+#if defined(__linux__)
+    (void)alinhamento;
+    munmap(p, tamanho);
+#else
+    ::operator delete(p, std::align_val_t(std::max(alinhamento, alignof(std::max_align_t))));
+#endif
+    mapeados -= tamanho;
+}
+
+ArenaArvore::ArenaArvore(size_t reservaInicial)
+    : monotonico(arredondarPagina(reservaInicial), &paginas) {}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+// --- ARENA POR ÁRVORE ---
+// Tudo o que pertence a uma árvore carregada (vértices, segmentos, topologia,
+// tabelas de caminho, cópia para a GPU) sai de um monotonic_buffer_resource:
+// alocar é só avançar um ponteiro, liberar um objeto não faz nada e descarregar
+// a árvore devolve tudo de uma vez. Carregar muitos steps seguidos não
+// fragmenta o heap.
+//
+// Os blocos vêm de páginas grandes: MAP_HUGETLB quando o sistema tem páginas
+// reservadas, senão mmap comum com MADV_HUGEPAGE (THP). Fora do Linux, new
+// alinhado.
+class RecursoPaginasGrandes : public std::pmr::memory_resource {
+public:
+    static constexpr size_t PAGINA = size_t(2) << 20;   // 2 MiB
+
+    size_t bytesMapeados() const { return mapeados; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alinhamento) override;
+    void do_deallocate(void* p, size_t bytes, size_t alinhamento) override;
+    bool do_is_equal(const std::pmr::memory_resource& outro) const noexcept override { return this == &outro; }
+
+    size_t mapeados = 0;
+};
+
+class ArenaArvore {
+public:
+    // 'reservaInicial' dimensiona o primeiro bloco (ex.: pelo tamanho do arquivo);
+    // os seguintes crescem em progressão geométrica
+    explicit ArenaArvore(size_t reservaInicial = RecursoPaginasGrandes::PAGINA);
+    ArenaArvore(const ArenaArvore&) = delete;
+    ArenaArvore& operator=(const ArenaArvore&) = delete;
+
+    std::pmr::memory_resource* recurso() { return &monotonico; }
+    // Devolve todos os blocos; nada alocado daqui pode continuar em uso
+    void liberar() { monotonico.release(); }
+    size_t bytesReservados() const { return paginas.bytesMapeados(); }
+
+private:
+    RecursoPaginasGrandes paginas;        // declarado antes: o monotônico libera nele
+    std::pmr::monotonic_buffer_resource monotonico;
+};
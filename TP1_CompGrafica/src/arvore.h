@@ -0,0 +1,33 @@
+#pragma once
+
+#include <memory_resource>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// --- ESTRUTURAS ---
+struct Ponto { glm::vec3 posicao; };
+struct Segmento { int indicePontoA; int indicePontoB; float raio; glm::vec3 cor; }; // Adicionamos COR aqui
+// Os arrays usam o recurso de memória passado na construção (ex.: ArenaArvore);
+// sem ele, o heap de sempre
+struct Arvore2D {
+    std::pmr::vector<Ponto> vertices;
+    std::pmr::vector<Segmento> segmentos;
+
+    explicit Arvore2D(std::pmr::memory_resource* recurso = std::pmr::get_default_resource())
+        : vertices(recurso), segmentos(recurso) {}
+};
+
+// --- ESPECIALIZAÇÃO POR DIMENSÃO ---
+// A dimensão é detectada uma vez na carga (detectarDimensao) e o visualizador
+// roda a instância certa: em 2D só x,y vão para a GPU e não há depth test;
+// em 3D entram o z e o depth buffer. Arvore2D continua sendo a única cópia na
+// CPU: as posições com D componentes só existem no buffer de vértices.
+
+// Layout de vértice na GPU: D floats de posição seguidos da cor
+template <int D>
+struct VerticeGPU {
+    static_assert(D == 2 || D == 3, "VerticeGPU so existe em 2D ou 3D");
+    glm::vec<D, float> posicao;
+    glm::vec3 cor;
+};
@@ -0,0 +1,147 @@
+#include "arvore_soa.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+ArvoreSoA paraSoA(const Arvore2D& arvore) {
+    ArvoreSoA s;
+    size_t nV = arvore.vertices.size(), nS = arvore.segmentos.size();
+    s.x.resize(nV); s.y.resize(nV); s.z.resize(nV);
+    for (size_t i = 0; i < nV; i++) {
+        const glm::vec3& p = arvore.vertices[i].posicao;
+        s.x[i] = p.x; s.y[i] = p.y; s.z[i] = p.z;
+    }
+    s.a.resize(nS); s.b.resize(nS); s.raio.resize(nS);
+    s.corR.resize(nS); s.corG.resize(nS); s.corB.resize(nS);
+    for (size_t i = 0; i < nS; i++) {
+        const Segmento& seg = arvore.segmentos[i];
+        s.a[i] = seg.indicePontoA; s.b[i] = seg.indicePontoB; s.raio[i] = seg.raio;
+        s.corR[i] = seg.cor.r; s.corG[i] = seg.cor.g; s.corB[i] = seg.cor.b;
+    }
+    return s;
+}
+
+Arvore2D paraArvore2D(const ArvoreSoA& s) {
+    Arvore2D arvore;
+    arvore.vertices.resize(s.nVertices());
+    for (size_t i = 0; i < s.nVertices(); i++) arvore.vertices[i].posicao = glm::vec3(s.x[i], s.y[i], s.z[i]);
+    arvore.segmentos.resize(s.nSegmentos());
+    for (size_t i = 0; i < s.nSegmentos(); i++) {
+        Segmento& seg = arvore.segmentos[i];
+        seg.indicePontoA = s.a[i]; seg.indicePontoB = s.b[i]; seg.raio = s.raio[i];
+        seg.cor = glm::vec3(s.corR[i], s.corG[i], s.corB[i]);
+    }
+    return arvore;
+}
+
+namespace {
+
+// Mínimo e máximo de um array; NaN é ignorado como nos laços escalares abaixo
+void minMax(const float* v, size_t n, float& menor, float& maior) {
+    size_t i = 0;
+    float mn = std::numeric_limits<float>::infinity(), mx = -mn;
+#if defined(__AVX2__)
+    __m256 vmn = _mm256_set1_ps(mn), vmx = _mm256_set1_ps(mx);
+    __m256 vmn2 = vmn, vmx2 = vmx;   // dois acumuladores escondem a latência
+    for (; i + 16 <= n; i += 16) {
+        __m256 p = _mm256_load_ps(v + i), q = _mm256_load_ps(v + i + 8);
+        vmn = _mm256_min_ps(p, vmn); vmx = _mm256_max_ps(p, vmx);
+        vmn2 = _mm256_min_ps(q, vmn2); vmx2 = _mm256_max_ps(q, vmx2);
+    }
+    alignas(32) float bmn[8], bmx[8];
+    _mm256_store_ps(bmn, _mm256_min_ps(vmn, vmn2));
+    _mm256_store_ps(bmx, _mm256_max_ps(vmx, vmx2));
+    for (int k = 0; k < 8; k++) { mn = std::min(mn, bmn[k]); mx = std::max(mx, bmx[k]); }
+#elif defined(__ARM_NEON)
+    float32x4_t vmn = vdupq_n_f32(mn), vmx = vdupq_n_f32(mx);
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t p = vld1q_f32(v + i);
+        vmn = vminnmq_f32(vmn, p); vmx = vmaxnmq_f32(vmx, p);
+    }
+    mn = vminnmvq_f32(vmn); mx = vmaxnmvq_f32(vmx);
+#endif
+    for (; i < n; i++) {
+        if (v[i] < mn) mn = v[i];
+        if (v[i] > mx) mx = v[i];
+    }
+    menor = mn; maior = mx;
+}
+
+} // namespace
+
+CaixaEnvolvente caixaEnvolvente(const ArvoreSoA& s) {
+    CaixaEnvolvente c;
+    size_t n = s.nVertices();
+    minMax(s.x.data(), n, c.minimo.x, c.maximo.x);
+    minMax(s.y.data(), n, c.minimo.y, c.maximo.y);
+    minMax(s.z.data(), n, c.minimo.z, c.maximo.z);
+    return c;
+}
+
+bool faixaRaio(const ArvoreSoA& s, float& menor, float& maior) {
+    if (s.nSegmentos() == 0) return false;
+    minMax(s.raio.data(), s.nSegmentos(), menor, maior);
+    return true;
+}
+
+void comprimentosSegmentos(const ArvoreSoA& s, float* saida) {
+    size_t n = s.nSegmentos(), i = 0;
+    const int32_t* a = s.a.data();
+    const int32_t* b = s.b.data();
+    const float* x = s.x.data();
+    const float* y = s.y.data();
+    const float* z = s.z.data();
+#if defined(__AVX2__)
+    // Busca escalar e conta vetorial: com índices espalhados o vpgatherdd
+    // sai mais lento que oito leituras simples
+    for (; i + 8 <= n; i += 8) {
+        alignas(32) float dx[8], dy[8], dz[8];
+        for (int k = 0; k < 8; k++) {
+            dx[k] = x[b[i + k]] - x[a[i + k]]; dy[k] = y[b[i + k]] - y[a[i + k]]; dz[k] = z[b[i + k]] - z[a[i + k]];
+        }
+        __m256 vx = _mm256_load_ps(dx), vy = _mm256_load_ps(dy), vz = _mm256_load_ps(dz);
+        __m256 d2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz));
+        _mm256_storeu_ps(saida + i, _mm256_sqrt_ps(d2));
+    }
+#elif defined(__ARM_NEON)
+    // NEON não tem gather: mesma ideia
+    for (; i + 4 <= n; i += 4) {
+        float dx[4], dy[4], dz[4];
+        for (int k = 0; k < 4; k++) {
+            dx[k] = x[b[i + k]] - x[a[i + k]]; dy[k] = y[b[i + k]] - y[a[i + k]]; dz[k] = z[b[i + k]] - z[a[i + k]];
+        }
+        float32x4_t vx = vld1q_f32(dx), vy = vld1q_f32(dy), vz = vld1q_f32(dz);
+        float32x4_t d2 = vfmaq_f32(vfmaq_f32(vmulq_f32(vx, vx), vy, vy), vz, vz);
+        vst1q_f32(saida + i, vsqrtq_f32(d2));
+    }
+#endif
+    for (; i < n; i++) {
+        float dx = x[b[i]] - x[a[i]], dy = y[b[i]] - y[a[i]], dz = z[b[i]] - z[a[i]];
+        saida[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+}
+
+void transformarVertices(const ArvoreSoA& s, const glm::mat4& m, float* ox, float* oy, float* oz) {
+    // Laço simples de multiplica-soma: o compilador vetoriza sozinho (com teste
+    // de sobreposição em tempo de execução, já que o destino pode ser a origem)
+    size_t n = s.nVertices();
+    const float* x = s.x.data();
+    const float* y = s.y.data();
+    const float* z = s.z.data();
+    const float m00 = m[0][0], m01 = m[1][0], m02 = m[2][0], m03 = m[3][0];
+    const float m10 = m[0][1], m11 = m[1][1], m12 = m[2][1], m13 = m[3][1];
+    const float m20 = m[0][2], m21 = m[1][2], m22 = m[2][2], m23 = m[3][2];
+    for (size_t i = 0; i < n; i++) {
+        float px = x[i], py = y[i], pz = z[i];
+        ox[i] = m00 * px + m01 * py + m02 * pz + m03;
+        oy[i] = m10 * px + m11 * py + m12 * pz + m13;
+        oz[i] = m20 * px + m21 * py + m22 * pz + m23;
+    }
+}
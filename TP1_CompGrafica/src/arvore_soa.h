@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "arvore.h"
+
+// --- ÁRVORE EM ESTRUTURA DE ARRAYS (SoA) ---
+// Mesmo conteúdo de Arvore2D, mas cada campo no seu array contínuo e alinhado
+// a 64 bytes (linha de cache / registrador AVX-512), para as passadas que
+// varrem a árvore inteira: caixa envolvente, faixa de raios, comprimentos e
+// transformações na CPU. Com AVX2 (x86) ou NEON (ARM) os kernels usam
+// intrínsecos; sem eles caem em laços simples. Veja ARVORE_NATIVO no CMake.
+// O bench_loader confere cada kernel contra o laço escalar sobre Arvore2D.
+
+template <typename T, size_t ALINHAMENTO = 64>
+struct AlocadorAlinhado {
+    using value_type = T;
+    template <typename U> struct rebind { using other = AlocadorAlinhado<U, ALINHAMENTO>; };
+
+    AlocadorAlinhado() = default;
+    template <typename U> AlocadorAlinhado(const AlocadorAlinhado<U, ALINHAMENTO>&) {}
+
+    T* allocate(size_t n) {
+        size_t bytes = (n * sizeof(T) + ALINHAMENTO - 1) / ALINHAMENTO * ALINHAMENTO;
+        void* p = std::aligned_alloc(ALINHAMENTO, bytes ? bytes : ALINHAMENTO);
+        if (!p) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+    void deallocate(T* p, size_t) { std::free(p); }
+
+    template <typename U> bool operator==(const AlocadorAlinhado<U, ALINHAMENTO>&) const { return true; }
+    template <typename U> bool operator!=(const AlocadorAlinhado<U, ALINHAMENTO>&) const { return false; }
+};
+
+template <typename T>
+using VetorAlinhado = std::vector<T, AlocadorAlinhado<T>>;
+
+struct ArvoreSoA {
+    // Vértices
+    VetorAlinhado<float> x, y, z;
+    // Segmentos
+    VetorAlinhado<int32_t> a, b;
+    VetorAlinhado<float> raio;
+    VetorAlinhado<float> corR, corG, corB;
+
+    size_t nVertices() const { return x.size(); }
+    size_t nSegmentos() const { return a.size(); }
+};
+
+// Adaptadores para quem ainda usa Arvore2D
+ArvoreSoA paraSoA(const Arvore2D& arvore);
+Arvore2D paraArvore2D(const ArvoreSoA& arvore);
+
+// --- KERNELS ---
+struct CaixaEnvolvente {
+    glm::vec3 minimo, maximo;
+};
+
+// Caixa vazia (min > max) se não houver vértices
+CaixaEnvolvente caixaEnvolvente(const ArvoreSoA& arvore);
+// Menor e maior raio; false se não houver segmentos
+bool faixaRaio(const ArvoreSoA& arvore, float& menor, float& maior);
+// saida[s] = |B - A| (índices precisam ser válidos)
+void comprimentosSegmentos(const ArvoreSoA& arvore, float* saida);
+// Aplica a matriz (ponto, w = 1) em todos os vértices: destino pode ser a própria árvore
+void transformarVertices(const ArvoreSoA& origem, const glm::mat4& m, float* x, float* y, float* z);
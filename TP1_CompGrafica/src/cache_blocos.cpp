@@ -0,0 +1,283 @@
+#include "cache_blocos.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "rastreio.h"
+
+const char* CacheBlocos2D::fonteVertice = "#version 330 core\n"
+    "layout (location = 0) in vec2 aPos;\n"
+    "layout (location = 1) in vec2 aUV;\n"
+    "out vec2 uv;\n"
+    "uniform mat4 transform;\n"
+    "void main(){ gl_Position = transform * vec4(aPos, 0.0, 1.0); uv = aUV; }\n";
+
+const char* CacheBlocos2D::fonteFragmento = "#version 330 core\n"
+    "out vec4 FragColor;\n"
+    "in vec2 uv;\n"
+    "uniform sampler2D bloco;\n"
+    "void main(){ FragColor = texture(bloco, uv); }\n";
+
+void CacheBlocos2D::iniciar(const VerticeGPU<2>* vertices, int nSegs, GLuint vao, GLuint progCena, GLint locCena,
+                            GLuint progBlocos) {
+    RASTREIO_ESCOPO("CacheBlocos2D::iniciar");
+    nSegmentos = nSegs;
+    vaoCena = vao;
+    programaCena = progCena;
+    locTransformCena = locCena;
+    programaBlocos = progBlocos;
+    locTransformBlocos = glGetUniformLocation(programaBlocos, "transform");
+    glUseProgram(programaBlocos);
+    glUniform1i(glGetUniformLocation(programaBlocos, "bloco"), 0);
+
+    // Quadrado do nível 0, com uma folga para as bordas não caírem no último texel
+    glm::vec2 mn(0.0f), mx(0.0f);
+    for (int i = 0; i < 2 * nSegmentos; i++) {
+        mn = i ? glm::min(mn, vertices[i].posicao) : vertices[i].posicao;
+        mx = i ? glm::max(mx, vertices[i].posicao) : vertices[i].posicao;
+    }
+    lado = std::max(std::max(mx.x - mn.x, mx.y - mn.y) * 1.02f, 1e-6f);
+    origem = 0.5f * (mn + mx) - glm::vec2(0.5f * lado);
+
+    // Segmentos agrupados por célula (contagem + prefixo), com a caixa de cada célula
+    celulas.assign((size_t)GRADE * GRADE, Celula());
+    std::vector<int> celulaDe(nSegmentos);
+    for (int s = 0; s < nSegmentos; s++) {
+        glm::vec2 a = vertices[2 * s].posicao, b = vertices[2 * s + 1].posicao;
+        glm::vec2 m = (0.5f * (a + b) - origem) / lado * (float)GRADE;
+        int cx = std::min(std::max((int)m.x, 0), GRADE - 1), cy = std::min(std::max((int)m.y, 0), GRADE - 1);
+        int k = cy * GRADE + cx;
+        Celula& cel = celulas[k];
+        cel.minimo = cel.quantidade ? glm::min(cel.minimo, glm::min(a, b)) : glm::min(a, b);
+        cel.maximo = cel.quantidade ? glm::max(cel.maximo, glm::max(a, b)) : glm::max(a, b);
+        cel.quantidade += 2;
+        celulaDe[s] = k;
+    }
+    GLuint soma = 0;
+    for (Celula& cel : celulas) { cel.inicio = soma; soma += cel.quantidade; }
+    std::vector<GLuint> indices(soma);
+    std::vector<GLuint> escrita(celulas.size());
+    for (size_t k = 0; k < celulas.size(); k++) escrita[k] = celulas[k].inicio;
+    for (int s = 0; s < nSegmentos; s++) {
+        GLuint& p = escrita[celulaDe[s]];
+        indices[p++] = 2 * s;
+        indices[p++] = 2 * s + 1;
+    }
+
+    // O EBO fica gravado no VAO da cena; glDrawArrays continua ignorando-o
+    glBindVertexArray(vaoCena);
+    glGenBuffers(1, &ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+    glBindVertexArray(0);
+
+    glGenFramebuffers(1, &fbo);
+    glGenVertexArrays(1, &vaoQuad); glGenBuffers(1, &vboQuad);
+    glBindVertexArray(vaoQuad); glBindBuffer(GL_ARRAY_BUFFER, vboQuad);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+    iniciado = true;
+}
+
+void CacheBlocos2D::liberar() {
+    if (!iniciado) return;
+    for (Bloco& b : blocos) glDeleteTextures(1, &b.textura);
+    blocos.clear();
+    porChave.clear();
+    glDeleteBuffers(1, &ebo);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteVertexArrays(1, &vaoQuad); glDeleteBuffers(1, &vboQuad);
+    iniciado = false;
+}
+
+void CacheBlocos2D::invalidar() {
+    for (Bloco& b : blocos) b.valido = false;
+    porChave.clear();
+    fila.clear();
+    proximo = 0;
+}
+
+glm::vec2 CacheBlocos2D::cantoBloco(int n, int ix, int iy) const {
+    return origem + glm::vec2((float)ix, (float)iy) * ladoBloco(n);
+}
+
+bool CacheBlocos2D::agendar(const glm::mat4& mvp, int w, int h, int segmentosVisiveis) {
+    if (!iniciado || w <= 0 || h <= 0) return false;
+    if (segmentosVisiveis != segmentosCacheados) {   // K/J mudou o que está na árvore
+        invalidar();
+        segmentosCacheados = segmentosVisiveis;
+    }
+    quadro++;
+    larguraTela = w; alturaTela = h;
+
+    // Pixels por unidade do mundo (pelo eixo y, que não leva o aspecto)
+    float px = glm::length(glm::vec2(mvp[1][0] * 0.5f * w, mvp[1][1] * 0.5f * h));
+    if (!(px > 0.0f)) return false;
+    int n = (int)std::ceil(std::log2(std::max(px * lado / TEXELS, 1.0f)));
+    if (n > MAX_NIVEL) return false;
+    nivel = n;
+
+    // Caixa do mundo que aparece na tela (os cantos, pela inversa)
+    glm::mat4 inversa = glm::inverse(mvp);
+    glm::vec2 mn(0.0f), mx(0.0f);
+    for (int k = 0; k < 4; k++) {
+        glm::vec4 p = inversa * glm::vec4(k & 1 ? 1.0f : -1.0f, k & 2 ? 1.0f : -1.0f, 0.0f, 1.0f);
+        glm::vec2 q(p.x / p.w, p.y / p.w);
+        mn = k ? glm::min(mn, q) : q;
+        mx = k ? glm::max(mx, q) : q;
+    }
+    float t = ladoBloco(nivel);
+    int ultimo = (1 << nivel) - 1;
+    ix0 = std::max(0, (int)std::floor((mn.x - origem.x) / t)); ix1 = std::min(ultimo, (int)std::floor((mx.x - origem.x) / t));
+    iy0 = std::max(0, (int)std::floor((mn.y - origem.y) / t)); iy1 = std::min(ultimo, (int)std::floor((mx.y - origem.y) / t));
+    fila.clear();
+    proximo = 0;
+    if (ix0 > ix1 || iy0 > iy1) return true;   // árvore fora da tela
+    if ((ix1 - ix0 + 1) * (iy1 - iy0 + 1) > MAX_BLOCOS / 2) return false;
+
+    // Visíveis primeiro; depois o anel em volta, para o próximo passo do pan
+    for (int anel = 0; anel <= 1; anel++)
+        for (int iy = std::max(0, iy0 - anel); iy <= std::min(ultimo, iy1 + anel); iy++)
+            for (int ix = std::max(0, ix0 - anel); ix <= std::min(ultimo, ix1 + anel); ix++) {
+                bool dentro = ix >= ix0 && ix <= ix1 && iy >= iy0 && iy <= iy1;
+                if (anel == 1 && dentro) continue;
+                auto it = porChave.find(chave(nivel, ix, iy));
+                if (it != porChave.end()) blocos[it->second].ultimoUso = quadro;
+                else fila.push_back(chave(nivel, ix, iy));
+            }
+    return true;
+}
+
+int CacheBlocos2D::slotLivre() {
+    for (int i = 0; i < (int)blocos.size(); i++)
+        if (!blocos[i].valido) return i;   // sobra de um invalidar()
+    if ((int)blocos.size() < MAX_BLOCOS) {
+        Bloco b;
+        glGenTextures(1, &b.textura);
+        glBindTexture(GL_TEXTURE_2D, b.textura);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, TEXELS, TEXELS, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        blocos.push_back(b);
+        return (int)blocos.size() - 1;
+    }
+    // LRU, sem tocar no que foi usado neste quadro
+    int melhor = -1;
+    for (int i = 0; i < (int)blocos.size(); i++) {
+        if (blocos[i].ultimoUso < quadro && (melhor < 0 || blocos[i].ultimoUso < blocos[melhor].ultimoUso)) melhor = i;
+    }
+    if (melhor >= 0) {
+        porChave.erase(blocos[melhor].chave);
+        blocos[melhor].valido = false;
+    }
+    return melhor;
+}
+
+void CacheBlocos2D::renderizar(int slot, int n, int ix, int iy) {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, blocos[slot].textura, 0);
+    glViewport(0, 0, TEXELS, TEXELS);
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glm::vec2 c = cantoBloco(n, ix, iy);
+    float t = ladoBloco(n);
+    glm::mat4 mvp = glm::ortho(c.x, c.x + t, c.y, c.y + t, -1.0f, 1.0f);
+    glUseProgram(programaCena);
+    glUniformMatrix4fv(locTransformCena, 1, GL_FALSE, glm::value_ptr(mvp));
+    glBindVertexArray(vaoCena);
+    if (segmentosCacheados == nSegmentos) {
+        // Células que tocam o bloco, com as vizinhas no índice juntadas numa chamada só
+        GLuint inicio = 0, fim = 0;
+        auto enviar = [&]() {
+            if (fim > inicio) {
+                glDrawElements(GL_LINES, fim - inicio, GL_UNSIGNED_INT, (void*)(inicio * sizeof(GLuint)));
+                chamadas++;
+            }
+            inicio = fim = 0;
+        };
+        for (const Celula& cel : celulas) {
+            bool toca = cel.quantidade && cel.maximo.x >= c.x && cel.minimo.x <= c.x + t && cel.maximo.y >= c.y && cel.minimo.y <= c.y + t;
+            if (!toca) continue;
+            if (fim != cel.inicio) { enviar(); inicio = cel.inicio; }
+            fim = cel.inicio + cel.quantidade;
+        }
+        enviar();
+    } else {
+        glDrawArrays(GL_LINES, 0, segmentosCacheados * 2);   // crescendo (K/J): o índice das células não se aplica
+        chamadas++;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, larguraTela, alturaTela);
+}
+
+bool CacheBlocos2D::preencher(int maxBlocos) {
+    RASTREIO_ESCOPO("preencher blocos");
+    for (int feitos = 0; feitos < maxBlocos && proximo < fila.size();) {
+        uint64_t k = fila[proximo++];
+        if (porChave.count(k)) continue;
+        int slot = slotLivre();
+        if (slot < 0) { proximo = fila.size(); break; }   // tudo em uso neste quadro
+        int n = (int)(k >> 58), ix = (int)((k >> 29) & 0x1FFFFFFF), iy = (int)(k & 0x1FFFFFFF);
+        renderizar(slot, n, ix, iy);
+        blocos[slot].chave = k;
+        blocos[slot].ultimoUso = quadro;
+        blocos[slot].valido = true;
+        porChave[k] = slot;
+        feitos++;
+    }
+    return pendentes();
+}
+
+void CacheBlocos2D::compor(const glm::mat4& mvp) {
+    compostos = faltando = 0;
+    // Quatro floats por vértice (x, y, u, v), seis vértices por bloco
+    std::vector<float> quads;
+    std::vector<GLuint> texturas;
+    float t = ladoBloco(nivel);
+    for (int iy = iy0; iy <= iy1; iy++)
+        for (int ix = ix0; ix <= ix1; ix++) {
+            glm::vec2 uv0(0.0f), uv1(1.0f);
+            int slot = -1;
+            for (int k = 0; k <= nivel && slot < 0; k++) {
+                auto it = porChave.find(chave(nivel - k, ix >> k, iy >> k));
+                if (it == porChave.end()) continue;
+                slot = it->second;
+                // Recorte do ancestral que cobre este bloco
+                float fracao = 1.0f / (float)(1 << k);
+                uv0 = glm::vec2((float)(ix - ((ix >> k) << k)), (float)(iy - ((iy >> k) << k))) * fracao;
+                uv1 = uv0 + glm::vec2(fracao);
+            }
+            if (slot < 0) { faltando++; continue; }
+            if (uv1.x - uv0.x < 1.0f) faltando++;
+            else compostos++;
+            blocos[slot].ultimoUso = quadro;
+            glm::vec2 p0 = cantoBloco(nivel, ix, iy), p1 = p0 + glm::vec2(t);
+            const float v[24] = {p0.x, p0.y, uv0.x, uv0.y, p1.x, p0.y, uv1.x, uv0.y, p1.x, p1.y, uv1.x, uv1.y,
+                                 p0.x, p0.y, uv0.x, uv0.y, p1.x, p1.y, uv1.x, uv1.y, p0.x, p1.y, uv0.x, uv1.y};
+            quads.insert(quads.end(), v, v + 24);
+            texturas.push_back(blocos[slot].textura);
+        }
+    if (texturas.empty()) return;
+
+    glUseProgram(programaBlocos);
+    glUniformMatrix4fv(locTransformBlocos, 1, GL_FALSE, glm::value_ptr(mvp));
+    glBindVertexArray(vaoQuad);
+    glBindBuffer(GL_ARRAY_BUFFER, vboQuad);
+    glBufferData(GL_ARRAY_BUFFER, quads.size() * sizeof(float), quads.data(), GL_STREAM_DRAW);
+    glActiveTexture(GL_TEXTURE0);
+    for (size_t i = 0; i < texturas.size(); i++) {
+        glBindTexture(GL_TEXTURE_2D, texturas[i]);
+        glDrawArrays(GL_TRIANGLES, (GLint)(6 * i), 6);
+    }
+    chamadas += texturas.size();
+    glBindVertexArray(0);
+}
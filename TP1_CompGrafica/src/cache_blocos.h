@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "arvore.h"
+
+// --- CACHE DE BLOCOS (2D) ---
+// Em 2D o pan e o zoom só movem a imagem, então ela é guardada em blocos de
+// TEXELS x TEXELS renderizados em textura, numa quadtree sobre o quadrado que
+// envolve a árvore: o nível L tem 2^L x 2^L blocos, e o nível usado é o mais
+// raso cuja densidade de texels cobre a de pixels na tela. Enquanto o usuário
+// interage, o frame só compõe os blocos visíveis (um quad cada); o que falta
+// aparece recortado de um ancestral já pronto e entra na fila, que é
+// preenchida alguns blocos por frame e no ócio. Em repouso o visualizador volta
+// ao desenho exato.
+//
+// Para um bloco não custar a árvore inteira, os segmentos são agrupados numa
+// grade GRADE x GRADE pelo ponto médio (um índice de elementos por célula);
+// cada bloco desenha só as células cuja caixa o toca.
+//
+// Os blocos só são descartados por invalidar() (dados ou cores mudaram) ou
+// pelo LRU quando os MAX_BLOCOS texturas acabam.
+class CacheBlocos2D {
+public:
+    static const int TEXELS = 256;
+    static const int MAX_BLOCOS = 128;   // 256 KiB cada (RGBA8)
+    static const int MAX_NIVEL = 14;
+    static const int GRADE = 64;
+
+    // Programa de composição, para o GerenciadorProgramas
+    static const char* fonteVertice;
+    static const char* fonteFragmento;
+
+    // 'vertices' na ordem do buffer da cena (dois por segmento); o índice das
+    // células vai num EBO ligado a 'vaoCena'. Precisa do contexto ativo.
+    void iniciar(const VerticeGPU<2>* vertices, int nSegmentos, GLuint vaoCena, GLuint programaCena,
+                 GLint locTransformCena, GLuint programaBlocos);
+    void liberar();
+    bool pronto() const { return iniciado; }
+
+    void invalidar();
+    // Decide nível e blocos para a câmera 'mvp' na janela de w x h pixels e
+    // refaz a fila (visíveis primeiro, depois um anel em volta). false se a
+    // vista não cabe no cache (ex.: zoom além de MAX_NIVEL): desenhe exato.
+    bool agendar(const glm::mat4& mvp, int w, int h, int segmentosVisiveis);
+    // Renderiza até 'maxBlocos' da fila; true se ainda restam
+    bool preencher(int maxBlocos);
+    bool pendentes() const { return proximo < fila.size(); }
+    // Desenha os blocos do último agendar() (ou o recorte de um ancestral)
+    void compor(const glm::mat4& mvp);
+
+    int blocosCompostos() const { return compostos; }
+    int blocosFaltando() const { return faltando; }
+    // Chamadas de desenho feitas até agora (blocos renderizados + composição)
+    size_t chamadasDesenho() const { return chamadas; }
+
+private:
+    struct Bloco { GLuint textura = 0; uint64_t chave = 0; uint64_t ultimoUso = 0; bool valido = false; };
+    struct Celula { GLuint inicio = 0, quantidade = 0; glm::vec2 minimo, maximo; };
+
+    static uint64_t chave(int nivel, int ix, int iy) { return ((uint64_t)nivel << 58) | ((uint64_t)ix << 29) | (uint64_t)iy; }
+    glm::vec2 cantoBloco(int nivel, int ix, int iy) const;
+    float ladoBloco(int nivel) const { return lado / (float)(1 << nivel); }
+    int slotLivre();
+    void renderizar(int slot, int nivel, int ix, int iy);
+
+    bool iniciado = false;
+    glm::vec2 origem = glm::vec2(0.0f);
+    float lado = 1.0f;
+    int nSegmentos = 0, segmentosCacheados = -1;
+
+    std::vector<Celula> celulas;
+    GLuint vaoCena = 0, ebo = 0, programaCena = 0, programaBlocos = 0;
+    GLint locTransformCena = -1, locTransformBlocos = -1;
+    GLuint fbo = 0, vaoQuad = 0, vboQuad = 0;
+
+    std::vector<Bloco> blocos;
+    std::unordered_map<uint64_t, int> porChave;
+    uint64_t quadro = 0;
+
+    // Resultado do último agendar()
+    int nivel = 0, ix0 = 0, iy0 = 0, ix1 = -1, iy1 = -1;
+    int larguraTela = 0, alturaTela = 0;
+    std::vector<uint64_t> fila;
+    size_t proximo = 0;
+    int compostos = 0, faltando = 0;
+    size_t chamadas = 0;
+};
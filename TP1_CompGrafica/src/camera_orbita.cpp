@@ -0,0 +1,64 @@
+#include "camera_orbita.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+void CameraOrbita::enquadrar(const glm::vec3& centro, float raio) {
+    alvo = centro;
+    raioCena = std::max(raio, 1e-6f);
+    distancia = 1.1f * raioCena / std::sin(glm::radians(fovY) * 0.5f);
+    orientacao = glm::angleAxis(glm::radians(-20.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+}
+
+glm::vec3 CameraOrbita::posicao() const {
+    return alvo + orientacao * glm::vec3(0.0f, 0.0f, distancia);
+}
+
+glm::mat4 CameraOrbita::visao() const {
+    glm::mat4 v = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -distancia));
+    v = v * glm::mat4_cast(glm::conjugate(orientacao));
+    return glm::translate(v, -alvo);
+}
+
+glm::mat4 CameraOrbita::projecao(float aspecto) const {
+    // Planos justos em volta da esfera da cena: mais precisão no depth buffer
+    float perto = std::max(distancia - 1.5f * raioCena, distancia * 1e-3f);
+    float longe = distancia + 1.5f * raioCena;
+    return glm::perspective(glm::radians(fovY), aspecto, perto, longe);
+}
+
+namespace {
+
+// Ponto da tela projetado na esfera unitária (fora dela, na borda)
+glm::vec3 naEsfera(const glm::vec2& p) {
+    float d2 = p.x * p.x + p.y * p.y;
+    if (d2 <= 1.0f) return glm::vec3(p.x, p.y, std::sqrt(1.0f - d2));
+    float d = std::sqrt(d2);
+    return glm::vec3(p.x / d, p.y / d, 0.0f);
+}
+
+} // namespace
+
+void CameraOrbita::arcball(const glm::vec2& a, const glm::vec2& b) {
+    glm::vec3 pa = naEsfera(a), pb = naEsfera(b);
+    glm::vec3 eixo = glm::cross(pa, pb);
+    float seno = glm::length(eixo);
+    if (seno < 1e-7f) return;
+    float angulo = std::atan2(seno, glm::dot(pa, pb));
+    // A cena gira com o cursor: a câmera gira ao contrário
+    girar(eixo / seno, -angulo);
+}
+
+void CameraOrbita::girar(const glm::vec3& eixoCamera, float angulo) {
+    orientacao = glm::normalize(orientacao * glm::angleAxis(angulo, eixoCamera));
+}
+
+void CameraOrbita::deslocar(float dx, float dy) {
+    alvo += orientacao * glm::vec3(dx * distancia, dy * distancia, 0.0f);
+}
+
+void CameraOrbita::aproximar(float fator) {
+    distancia = std::max(distancia / fator, raioCena * 1e-4f);
+}
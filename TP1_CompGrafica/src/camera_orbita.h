@@ -0,0 +1,31 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// --- CÂMERA 3D (órbita + arcball) ---
+// Olha sempre para 'alvo' a uma 'distancia'; a orientação é um quaternion,
+// então girar pelo arcball (mouse) ou pelo teclado não sofre gimbal lock.
+// Os eixos de giro do teclado são os da própria câmera (direita/cima/frente).
+struct CameraOrbita {
+    glm::vec3 alvo = glm::vec3(0.0f);
+    float distancia = 1.0f;
+    glm::quat orientacao = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);   // câmera -> mundo
+    float fovY = 45.0f;             // graus
+    float raioCena = 1.0f;          // para os planos near/far
+
+    // Árvore inteira na tela, com uma inclinação leve para o 3D aparecer
+    void enquadrar(const glm::vec3& centro, float raio);
+
+    glm::vec3 posicao() const;
+    glm::mat4 visao() const;
+    glm::mat4 projecao(float aspecto) const;
+
+    // a e b em coordenadas normalizadas da tela ([-1,1], y para cima, já corrigidas pelo aspecto)
+    void arcball(const glm::vec2& a, const glm::vec2& b);
+    // Giro em torno de um eixo da câmera (radianos)
+    void girar(const glm::vec3& eixoCamera, float angulo);
+    // Desloca o alvo no plano da tela, em frações da distância
+    void deslocar(float dx, float dy);
+    void aproximar(float fator);
+};
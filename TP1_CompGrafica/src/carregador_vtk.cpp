@@ -0,0 +1,555 @@
+#include "carregador_vtk.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib> // Para rand()
+#include <cstring>
+#include <ctime>   // Para time()
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#include "rastreio.h"
+
+// --- PARSER ---
+Arvore2D carregarVTK(const std::string& caminho) {
+    RASTREIO_ESCOPO("carregarVTK");
+    Arvore2D arvore;
+    uint64_t t0 = rastreio::agoraUs();
+    std::ifstream ficheiro(caminho);
+    rastreio::completo("abrir arquivo", t0, rastreio::agoraUs());
+    std::string linha;
+    if (!ficheiro.is_open()) {
+        std::cerr << "ERRO: Nao consegui abrir " << caminho << std::endl;
+        return arvore;
+    }
+
+    // Semente aleatória para cores
+    srand(time(NULL));
+
+    std::string estadoAtual = "HEADER";
+    int indiceRaioAtual = 0;
+    // Cada seção vira um evento no rastreio; fecha a anterior quando a próxima começa
+    const char* secaoAtual = "cabecalho";
+    uint64_t inicioSecao = rastreio::agoraUs();
+    auto trocarSecao = [&](const char* nova) {
+        uint64_t agora = rastreio::agoraUs();
+        rastreio::completo(secaoAtual, inicioSecao, agora);
+        secaoAtual = nova; inicioSecao = agora;
+    };
+    while (std::getline(ficheiro, linha)) {
+        if (linha.empty()) continue;
+        std::stringstream ss(linha); std::string palavra; ss >> palavra;
+        
+        if (palavra == "POINTS") { trocarSecao("secao POINTS"); estadoAtual = "POINTS"; int n; ss >> n; arvore.vertices.reserve(n); continue; }
+        else if (palavra == "LINES") { trocarSecao("secao LINES"); estadoAtual = "LINES"; int n; ss >> n; arvore.segmentos.reserve(n); continue; }
+        else if (palavra == "CELL_DATA") { trocarSecao("secao CELL_DATA"); estadoAtual = "CELL_DATA"; continue; }
+        else if (palavra == "scalars" || palavra == "LOOKUP_TABLE") continue; 
+
+        if (estadoAtual == "POINTS") {
+            std::stringstream ss_l(linha); Ponto p; ss_l >> p.posicao.x >> p.posicao.y >> p.posicao.z;
+            arvore.vertices.push_back(p);
+        } else if (estadoAtual == "LINES") {
+            std::stringstream ss_l(linha); int n; Segmento s; ss_l >> n >> s.indicePontoA >> s.indicePontoB;
+            if (n==2) { 
+                s.raio=0.0f; 
+                
+                // GERA COR ALEATÓRIA VIBRANTE PARA CADA SEGMENTO
+                // Evitamos cores muito escuras garantindo um mínimo de 0.2
+                float r = (rand() % 100) / 100.0f;
+                float g = (rand() % 100) / 100.0f;
+                float b = (rand() % 100) / 100.0f;
+                
+                // Opção: Se quiser distinguir vizinhos, random total é o melhor.
+                s.cor = glm::vec3(r, g, b);
+
+                arvore.segmentos.push_back(s); 
+            }
+        } else if (estadoAtual == "CELL_DATA") {
+            std::stringstream ss_l(linha); float r; ss_l >> r;
+            if (indiceRaioAtual < arvore.segmentos.size()) arvore.segmentos[indiceRaioAtual++].raio = r;
+        }
+    }
+    rastreio::completo(secaoAtual, inicioSecao, rastreio::agoraUs());
+    return arvore;
+}
+
+// --- PARSER RÁPIDO ---
+namespace {
+
+// Cursor sobre o arquivo inteiro em memória (terminado em '\0')
+struct Leitor {
+    const char* p;
+    const char* fim;
+
+    void pularEspacos() { while (p < fim && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++; }
+    void pularLinha() { while (p < fim && *p != '\n') p++; if (p < fim) p++; }
+
+    std::string palavra() {
+        pularEspacos();
+        const char* ini = p;
+        while (p < fim && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') p++;
+        return std::string(ini, p);
+    }
+
+    bool inteiro(long& v) {
+        pularEspacos();
+        bool neg = false;
+        if (p < fim && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+        if (p >= fim || *p < '0' || *p > '9') return false;
+        long r = 0;
+        while (p < fim && *p >= '0' && *p <= '9') r = r * 10 + (*p++ - '0');
+        v = neg ? -r : r;
+        return true;
+    }
+
+    // Binário (legacy VTK é big-endian); cabe() confere o tamanho antes
+    size_t restantes() const { return (size_t)(fim - p); }
+    bool cabe(size_t bytes) const { return restantes() >= bytes; }
+    uint32_t bits32() { uint32_t v; std::memcpy(&v, p, 4); p += 4; return __builtin_bswap32(v); }
+    int32_t int32BE() { return (int32_t)bits32(); }
+    float floatBE() { uint32_t b = bits32(); float v; std::memcpy(&v, &b, 4); return v; }
+    double doubleBE() {
+        uint64_t b; std::memcpy(&b, p, 8); p += 8; b = __builtin_bswap64(b);
+        double v; std::memcpy(&v, &b, 8); return v;
+    }
+
+    // Decimal com expoente opcional; precisão de sobra para float
+    bool real(float& v) {
+        pularEspacos();
+        bool neg = false;
+        if (p < fim && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+        double mantissa = 0.0;
+        int expoente = 0;
+        bool algum = false;
+        while (p < fim && *p >= '0' && *p <= '9') { mantissa = mantissa * 10.0 + (*p++ - '0'); algum = true; }
+        if (p < fim && *p == '.') {
+            p++;
+            while (p < fim && *p >= '0' && *p <= '9') { mantissa = mantissa * 10.0 + (*p++ - '0'); expoente--; algum = true; }
+        }
+        if (!algum) {
+            // nan/inf e afins: deixa para a biblioteca
+            char* depois = nullptr;
+            v = std::strtof(p, &depois);
+            if (depois == p) return false;
+            p = depois;
+            return true;
+        }
+        if (p < fim && (*p == 'e' || *p == 'E')) {
+            p++;
+            long e = 0;
+            if (!inteiro(e)) return false;
+            expoente += (int)e;
+        }
+        static const double potencias[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                           1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+        if (expoente < 0 && expoente >= -22) mantissa /= potencias[-expoente];
+        else if (expoente > 0 && expoente <= 22) mantissa *= potencias[expoente];
+        else if (expoente != 0) mantissa = std::strtod(("1e" + std::to_string(expoente)).c_str(), nullptr) * mantissa;
+        v = (float)(neg ? -mantissa : mantissa);
+        return true;
+    }
+};
+
+bool lerArquivoInteiro(const std::string& caminho, std::string& conteudo) {
+    FILE* f = std::fopen(caminho.c_str(), "rb");
+    if (!f) return false;
+    std::fseek(f, 0, SEEK_END);
+    long tamanho = std::ftell(f);
+    std::fseek(f, 0, SEEK_SET);
+    conteudo.resize(tamanho > 0 ? (size_t)tamanho : 0);
+    size_t lidos = conteudo.empty() ? 0 : std::fread(&conteudo[0], 1, conteudo.size(), f);
+    std::fclose(f);
+    conteudo.resize(lidos);
+    return true;
+}
+
+// Todo o resto (montarCena, hemodinâmica, caminhos, seleção) indexa vertices
+// direto com os índices dos segmentos
+int paraIndice(long v) { return v < 0 || v > std::numeric_limits<int>::max() ? -1 : (int)v; }
+
+bool indicesValidos(const Arvore2D& arvore) {
+    long nV = (long)arvore.vertices.size();
+    for (const Segmento& s : arvore.segmentos)
+        if (s.indicePontoA < 0 || s.indicePontoA >= nV || s.indicePontoB < 0 || s.indicePontoB >= nV) return false;
+    return true;
+}
+
+glm::vec3 corAleatoria() {
+    float r = (rand() % 100) / 100.0f;
+    float g = (rand() % 100) / 100.0f;
+    float b = (rand() % 100) / 100.0f;
+    return glm::vec3(r, g, b);
+}
+
+} // namespace
+
+Arvore2D carregarVTKRapido(const std::string& caminho, std::pmr::memory_resource* recurso) {
+    RASTREIO_ESCOPO("carregarVTKRapido");
+    Arvore2D arvore(recurso);
+    std::string conteudo;
+    {
+        RASTREIO_ESCOPO("ler arquivo");
+        if (!lerArquivoInteiro(caminho, conteudo)) {
+            std::cerr << "ERRO: Nao consegui abrir " << caminho << std::endl;
+            return arvore;
+        }
+    }
+
+    // Semente aleatória para cores
+    srand(time(NULL));
+
+    Leitor l{conteudo.c_str(), conteudo.c_str() + conteudo.size()};
+    // Cabeçalho: versão, título e formato ocupam as três primeiras linhas
+    l.pularLinha(); l.pularLinha();
+    std::string formato = l.palavra();
+    bool binario = formato == "BINARY";
+    if (!binario && formato != "ASCII") {
+        std::cerr << "ERRO: formato " << formato << " nao suportado em " << caminho << std::endl;
+        return arvore;
+    }
+    auto falhar = [&](const char* secao) {
+        std::cerr << "ERRO: secao " << secao << " truncada em " << caminho << std::endl;
+        return Arvore2D(recurso);
+    };
+
+    long nCelulas = 0;
+    bool temRaio = false;
+    while (true) {
+        std::string palavra = l.palavra();
+        if (palavra.empty()) break;
+
+        if (palavra == "POINTS") {
+            RASTREIO_ESCOPO("secao POINTS");
+            long n = 0; l.inteiro(n);
+            std::string tipo = l.palavra();
+            size_t largura = tipo == "double" ? 8 : 4;
+            // A contagem vem do arquivo: confere com o que resta antes de alocar
+            // (no ASCII, um ponto ocupa ao menos "0 0 0\n")
+            if (n < 0 || (size_t)n > l.restantes() / (binario ? 3 * largura : 6)) return falhar("POINTS");
+            arvore.vertices.resize(n);
+            if (binario) {
+                l.pularLinha();
+                if (!l.cabe(n * 3 * largura)) return falhar("POINTS");
+                for (long i = 0; i < n; i++) {
+                    glm::vec3& p = arvore.vertices[i].posicao;
+                    for (int c = 0; c < 3; c++) p[c] = largura == 8 ? (float)l.doubleBE() : l.floatBE();
+                }
+            } else {
+                for (long i = 0; i < n; i++) {
+                    glm::vec3& p = arvore.vertices[i].posicao;
+                    if (!l.real(p.x) || !l.real(p.y) || !l.real(p.z)) { arvore.vertices.resize(i); break; }
+                }
+            }
+        } else if (palavra == "LINES") {
+            RASTREIO_ESCOPO("secao LINES");
+            long n = 0, tamanho = 0; l.inteiro(n); l.inteiro(tamanho);
+            if (n < 0 || tamanho < 0 || (size_t)n > l.restantes() / 2 || (binario && n > tamanho)) return falhar("LINES");
+            arvore.segmentos.reserve(n);
+            if (binario) {
+                l.pularLinha();
+                if (tamanho < 0 || !l.cabe((size_t)tamanho * 4)) return falhar("LINES");
+            }
+            // No binário, cada célula ocupa k+1 dos 'tamanho' inteiros declarados:
+            // k vem do arquivo, então nada é lido além do que cabe() conferiu
+            long lidos = 0;
+            auto proximo = [&](long& v) {
+                if (!binario) return l.inteiro(v);
+                if (lidos >= tamanho) return false;
+                lidos++;
+                v = l.int32BE();
+                return true;
+            };
+            for (long i = 0; i < n; i++) {
+                long k = 0;
+                if (!proximo(k)) { if (binario) return falhar("LINES"); break; }
+                if (binario && (k < 0 || k > tamanho - lidos)) return falhar("LINES");
+                long a = 0, b = 0;
+                if (k == 2) {
+                    if (!proximo(a) || !proximo(b)) break;
+                    Segmento s; s.indicePontoA = paraIndice(a); s.indicePontoB = paraIndice(b); s.raio = 0.0f; s.cor = corAleatoria();
+                    arvore.segmentos.push_back(s);
+                } else {
+                    long j = 0;
+                    while (j < k && proximo(a)) j++;   // polilinhas são ignoradas, como no original
+                    if (j < k) break;
+                }
+            }
+            if (binario && lidos != tamanho) return falhar("LINES");   // n + soma(k) != tamanho
+        } else if (palavra == "CELL_DATA") {
+            l.inteiro(nCelulas);
+        } else if (palavra == "scalars" || palavra == "SCALARS") {
+            RASTREIO_ESCOPO("secao CELL_DATA");
+            std::string nome = l.palavra();
+            l.pularLinha();
+            const char* antes = l.p;
+            if (l.palavra() == "LOOKUP_TABLE") l.pularLinha();
+            else l.p = antes;
+            // O raio é o primeiro campo (ou o que se chama "raio"); os demais são pulados
+            bool ehRaio = !temRaio || nome == "raio";
+            size_t total = std::min((size_t)nCelulas, arvore.segmentos.size());
+            if (binario) {
+                if (!l.cabe(nCelulas * 4)) return falhar("CELL_DATA");
+                for (long i = 0; i < nCelulas; i++) {
+                    float v = l.floatBE();
+                    if (ehRaio && (size_t)i < total) arvore.segmentos[i].raio = v;
+                }
+            } else {
+                for (long i = 0; i < nCelulas; i++) {
+                    float v;
+                    if (!l.real(v)) break;
+                    if (ehRaio && (size_t)i < total) arvore.segmentos[i].raio = v;
+                }
+            }
+            temRaio = temRaio || ehRaio;
+        } else {
+            l.pularLinha();   // DATASET, POINT_DATA e outras seções que não usamos
+        }
+    }
+    if (!indicesValidos(arvore)) {
+        std::cerr << "ERRO: segmento com indice fora de POINTS em " << caminho << std::endl;
+        return Arvore2D(recurso);
+    }
+    return arvore;
+}
+
+// --- CACHE BINÁRIO ---
+namespace {
+
+struct CabecalhoCache {
+    char magica[4];      // "ARVB"
+    uint32_t versao;
+    uint64_t nVertices;
+    uint64_t nSegmentos;
+};
+const uint32_t VERSAO_CACHE = 1;
+
+} // namespace
+
+bool salvarCacheBruto(const std::string& caminho, const float* pos, size_t nVertices,
+                      const int32_t* indices, const float* raios, size_t nSegmentos) {
+    RASTREIO_ESCOPO("salvarCacheArvore");
+    std::ofstream saida(caminho, std::ios::binary);
+    if (!saida.is_open()) {
+        std::cerr << "ERRO: Nao consegui criar " << caminho << std::endl;
+        return false;
+    }
+    CabecalhoCache c;
+    std::memcpy(c.magica, "ARVB", 4);
+    c.versao = VERSAO_CACHE;
+    c.nVertices = nVertices;
+    c.nSegmentos = nSegmentos;
+    saida.write((const char*)&c, sizeof(c));
+    saida.write((const char*)pos, nVertices * 3 * sizeof(float));
+    saida.write((const char*)indices, nSegmentos * 2 * sizeof(int32_t));
+    saida.write((const char*)raios, nSegmentos * sizeof(float));
+    return (bool)saida;
+}
+
+bool salvarCacheArvore(const Arvore2D& arvore, const std::string& caminho) {
+    size_t nV = arvore.vertices.size(), nS = arvore.segmentos.size();
+    std::vector<float> pos(nV * 3);
+    for (size_t i = 0; i < nV; i++) {
+        const glm::vec3& p = arvore.vertices[i].posicao;
+        pos[3*i] = p.x; pos[3*i+1] = p.y; pos[3*i+2] = p.z;
+    }
+    std::vector<int32_t> indices(nS * 2);
+    std::vector<float> raios(nS);
+    for (size_t i = 0; i < nS; i++) {
+        indices[2*i] = arvore.segmentos[i].indicePontoA;
+        indices[2*i+1] = arvore.segmentos[i].indicePontoB;
+        raios[i] = arvore.segmentos[i].raio;
+    }
+    return salvarCacheBruto(caminho, pos.data(), nV, indices.data(), raios.data(), nS);
+}
+
+Arvore2D carregarCacheArvore(const std::string& caminho, std::pmr::memory_resource* recurso) {
+    RASTREIO_ESCOPO("carregarCacheArvore");
+    Arvore2D arvore(recurso);
+    std::ifstream entrada(caminho, std::ios::binary);
+    if (!entrada.is_open()) {
+        std::cerr << "ERRO: Nao consegui abrir " << caminho << std::endl;
+        return arvore;
+    }
+    CabecalhoCache c;
+    if (!entrada.read((char*)&c, sizeof(c)) || std::memcmp(c.magica, "ARVB", 4) != 0 || c.versao != VERSAO_CACHE) {
+        std::cerr << "ERRO: " << caminho << " nao e um cache de arvore valido" << std::endl;
+        return arvore;
+    }
+
+    // Contagens do cabeçalho contra o tamanho do arquivo, antes de alocar
+    std::error_code erro;
+    uint64_t bytes = std::filesystem::file_size(caminho, erro);
+    uint64_t resto = erro || bytes < sizeof(c) ? 0 : bytes - sizeof(c);
+    if (c.nVertices > resto / 12 || c.nSegmentos > (resto - c.nVertices * 12) / 12) {
+        std::cerr << "ERRO: cache truncado em " << caminho << std::endl;
+        return arvore;
+    }
+    std::vector<float> pos(c.nVertices * 3);
+    std::vector<int32_t> indices(c.nSegmentos * 2);
+    std::vector<float> raios(c.nSegmentos);
+    entrada.read((char*)pos.data(), pos.size() * sizeof(float));
+    entrada.read((char*)indices.data(), indices.size() * sizeof(int32_t));
+    entrada.read((char*)raios.data(), raios.size() * sizeof(float));
+    if (!entrada) {
+        std::cerr << "ERRO: cache truncado em " << caminho << std::endl;
+        return arvore;
+    }
+
+    srand(time(NULL));
+    arvore.vertices.resize(c.nVertices);
+    for (size_t i = 0; i < c.nVertices; i++)
+        arvore.vertices[i].posicao = glm::vec3(pos[3*i], pos[3*i+1], pos[3*i+2]);
+    arvore.segmentos.resize(c.nSegmentos);
+    for (size_t i = 0; i < c.nSegmentos; i++) {
+        Segmento& s = arvore.segmentos[i];
+        s.indicePontoA = indices[2*i]; s.indicePontoB = indices[2*i+1];
+        s.raio = raios[i]; s.cor = corAleatoria();
+    }
+    if (!indicesValidos(arvore)) {
+        std::cerr << "ERRO: segmento com indice fora dos vertices em " << caminho << std::endl;
+        return Arvore2D(recurso);
+    }
+    return arvore;
+}
+
+Arvore2D carregarArvore(const std::string& caminho, std::pmr::memory_resource* recurso) {
+    const std::string ext = ".arvb";
+    if (caminho.size() >= ext.size() && caminho.compare(caminho.size() - ext.size(), ext.size(), ext) == 0)
+        return carregarCacheArvore(caminho, recurso);
+    return carregarVTKRapido(caminho, recurso);
+}
+
+// --- RESUMO (CATÁLOGO) ---
+namespace {
+
+struct Faixa {
+    float menor = std::numeric_limits<float>::infinity(), maior = -std::numeric_limits<float>::infinity();
+    void incluir(float v) { menor = std::min(menor, v); maior = std::max(maior, v); }
+    bool vazia() const { return menor > maior; }
+};
+
+void incluirPonto(ResumoArvore& r, const glm::vec3& p, bool primeiro) {
+    r.minimo = primeiro ? p : glm::min(r.minimo, p);
+    r.maximo = primeiro ? p : glm::max(r.maximo, p);
+    if (p.z != 0.0f) r.dimensao = 3;
+}
+
+bool resumoCache(const std::string& caminho, ResumoArvore& r) {
+    std::ifstream entrada(caminho, std::ios::binary);
+    CabecalhoCache c;
+    if (!entrada.read((char*)&c, sizeof(c)) || std::memcmp(c.magica, "ARVB", 4) != 0 || c.versao != VERSAO_CACHE) return false;
+    r.nPontos = c.nVertices;
+    r.nSegmentos = c.nSegmentos;
+    std::vector<float> bloco(3 * 16384);
+    for (uint64_t i = 0; i < c.nVertices;) {
+        size_t n = (size_t)std::min<uint64_t>(16384, c.nVertices - i);
+        if (!entrada.read((char*)bloco.data(), n * 3 * sizeof(float))) return false;
+        for (size_t k = 0; k < n; k++) incluirPonto(r, glm::vec3(bloco[3*k], bloco[3*k+1], bloco[3*k+2]), i + k == 0);
+        i += n;
+    }
+    entrada.seekg(c.nSegmentos * 2 * sizeof(int32_t), std::ios::cur);   // índices não interessam
+    Faixa raio;
+    for (uint64_t i = 0; i < c.nSegmentos;) {
+        size_t n = (size_t)std::min<uint64_t>(bloco.size(), c.nSegmentos - i);
+        if (!entrada.read((char*)bloco.data(), n * sizeof(float))) return false;
+        for (size_t k = 0; k < n; k++) raio.incluir(bloco[k]);
+        i += n;
+    }
+    if (!raio.vazia()) { r.raioMin = raio.menor; r.raioMax = raio.maior; }
+    return true;
+}
+
+} // namespace
+
+bool lerResumoArvore(const std::string& caminho, ResumoArvore& r) {
+    RASTREIO_ESCOPO("lerResumoArvore");
+    r = ResumoArvore();
+    const std::string ext = ".arvb";
+    if (caminho.size() >= ext.size() && caminho.compare(caminho.size() - ext.size(), ext.size(), ext) == 0)
+        return resumoCache(caminho, r);
+
+    std::string conteudo;
+    if (!lerArquivoInteiro(caminho, conteudo)) return false;
+    Leitor l{conteudo.c_str(), conteudo.c_str() + conteudo.size()};
+    if (l.palavra() != "#") return false;   // "# vtk DataFile Version x.y"
+    l.pularLinha(); l.pularLinha();
+    std::string formato = l.palavra();
+    bool binario = formato == "BINARY";
+    if (!binario && formato != "ASCII") return false;
+
+    long nCelulas = 0;
+    bool temRaio = false;
+    while (true) {
+        std::string palavra = l.palavra();
+        if (palavra.empty()) break;
+        if (palavra == "POINTS") {
+            long n = 0; l.inteiro(n);
+            std::string tipo = l.palavra();
+            r.nPontos = (uint64_t)std::max(0L, n);
+            if (binario) {
+                l.pularLinha();
+                size_t largura = tipo == "double" ? 8 : 4;
+                if (!l.cabe(n * 3 * largura)) return false;
+                for (long i = 0; i < n; i++) {
+                    glm::vec3 p;
+                    for (int c = 0; c < 3; c++) p[c] = largura == 8 ? (float)l.doubleBE() : l.floatBE();
+                    incluirPonto(r, p, i == 0);
+                }
+            } else {
+                for (long i = 0; i < n; i++) {
+                    glm::vec3 p;
+                    if (!l.real(p.x) || !l.real(p.y) || !l.real(p.z)) { r.nPontos = i; break; }
+                    incluirPonto(r, p, i == 0);
+                }
+            }
+        } else if (palavra == "LINES") {
+            long n = 0, tamanho = 0; l.inteiro(n); l.inteiro(tamanho);
+            r.nSegmentos = (uint64_t)std::max(0L, n);
+            if (binario) {
+                l.pularLinha();
+                if (!l.cabe(tamanho * 4)) return false;
+                l.p += tamanho * 4;
+            } else {
+                // Sem converter os números: pula direto para a próxima seção
+                const char* proxima = std::strstr(l.p, "CELL_DATA");
+                l.p = proxima ? proxima : l.fim;
+            }
+        } else if (palavra == "CELL_DATA") {
+            l.inteiro(nCelulas);
+        } else if (palavra == "scalars" || palavra == "SCALARS") {
+            // Mesma regra do carregador: o primeiro campo, ou o que se chama "raio"
+            std::string nome = l.palavra();
+            l.pularLinha();
+            const char* antes = l.p;
+            if (l.palavra() == "LOOKUP_TABLE") l.pularLinha();
+            else l.p = antes;
+            bool ehRaio = !temRaio || nome == "raio";
+            Faixa faixa;
+            if (binario) {
+                if (!l.cabe(nCelulas * 4)) return false;
+                for (long i = 0; i < nCelulas; i++) faixa.incluir(l.floatBE());
+            } else {
+                for (long i = 0; i < nCelulas; i++) {
+                    float v;
+                    if (!l.real(v)) break;
+                    faixa.incluir(v);
+                }
+            }
+            if (ehRaio && !faixa.vazia()) { r.raioMin = faixa.menor; r.raioMax = faixa.maior; }
+            temRaio = temRaio || ehRaio;
+        } else {
+            l.pularLinha();
+        }
+    }
+    return true;
+}
+
+int detectarDimensao(const Arvore2D& arvore) {
+    for (const Ponto& p : arvore.vertices)
+        if (p.posicao.z != 0.0f) return 3;
+    return 2;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+
+#include "arvore.h"
+
+// --- CARREGADORES ---
+// Todos devolvem uma árvore vazia (sem vértices) em caso de erro. 'recurso'
+// é de onde saem os arrays da árvore (ArenaArvore::recurso() para pôr tudo
+// numa arena só); o padrão é o heap.
+
+// Parser original, linha a linha com stringstream (referência de comportamento)
+Arvore2D carregarVTK(const std::string& caminho);
+
+// Mesmo resultado que carregarVTK, mas lê o arquivo inteiro de uma vez e
+// converte os números direto do buffer, sem alocar por linha. Aceita também
+// o formato BINARY do legacy VTK.
+Arvore2D carregarVTKRapido(const std::string& caminho,
+                           std::pmr::memory_resource* recurso = std::pmr::get_default_resource());
+
+// Cache binário (.arvb): cabeçalho fixo seguido dos arrays crus, sem parsing
+bool salvarCacheArvore(const Arvore2D& arvore, const std::string& caminho);
+// pos = 3 floats por vértice, indices = 2 por segmento
+bool salvarCacheBruto(const std::string& caminho, const float* pos, size_t nVertices,
+                      const int32_t* indices, const float* raios, size_t nSegmentos);
+Arvore2D carregarCacheArvore(const std::string& caminho,
+                             std::pmr::memory_resource* recurso = std::pmr::get_default_resource());
+
+// Escolhe o carregador pela extensão (.arvb = cache, resto = VTK)
+Arvore2D carregarArvore(const std::string& caminho,
+                        std::pmr::memory_resource* recurso = std::pmr::get_default_resource());
+
+// Só o que o catálogo precisa, sem montar a árvore: contagens do cabeçalho,
+// caixa envolvente (varre POINTS) e faixa do raio (varre o campo do raio).
+// LINES é pulado inteiro. false se o arquivo não abre ou não é VTK/.arvb.
+struct ResumoArvore {
+    uint64_t nPontos = 0, nSegmentos = 0;   // nSegmentos = células de LINES
+    int dimensao = 2;                       // mesmo critério de detectarDimensao
+    glm::vec3 minimo = glm::vec3(0.0f), maximo = glm::vec3(0.0f);
+    float raioMin = 0.0f, raioMax = 0.0f;   // 0 e 0 sem campo de raio
+};
+bool lerResumoArvore(const std::string& caminho, ResumoArvore& resumo);
+
+// 2 se todos os vértices estão em z = 0, senão 3
+int detectarDimensao(const Arvore2D& arvore);
@@ -0,0 +1,161 @@
+#include "catalogo.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+#include "pool_tarefas.h"
+#include "rastreio.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* CABECALHO_INDICE = "# catalogo_cco v1";
+
+bool extensaoArvore(const fs::path& p) {
+    std::string ext = p.extension().string();
+    return ext == ".vtk" || ext == ".arvb";
+}
+
+bool antes(const EntradaCatalogo& a, const EntradaCatalogo& b) {
+    if (a.resumo.dimensao != b.resumo.dimensao) return a.resumo.dimensao < b.resumo.dimensao;
+    if (a.nTerm != b.nTerm) return a.nTerm < b.nTerm;
+    if (a.step != b.step) return a.step < b.step;
+    return a.caminho < b.caminho;
+}
+
+} // namespace
+
+bool lerNomePacote(const std::string& nomeArquivo, int& nTerm, int& step) {
+    int dimensao = 0;
+    if (std::sscanf(nomeArquivo.c_str(), "tree%dD_Nterm%d_step%d", &dimensao, &nTerm, &step) != 3) {
+        nTerm = step = -1;
+        return false;
+    }
+    return true;
+}
+
+bool Catalogo::carregarIndice(const std::string& caminho) {
+    RASTREIO_ESCOPO("carregarIndice");
+    lista.clear();
+    std::ifstream entrada(caminho);
+    std::string linha;
+    if (!entrada.is_open() || !std::getline(entrada, linha) || linha != CABECALHO_INDICE) return false;
+    // caminho \t tamanho \t data \t dim \t Nterm \t step \t pontos \t segmentos \t caixa (6) \t raio min \t raio max
+    while (std::getline(entrada, linha)) {
+        if (linha.empty()) continue;
+        size_t tab = linha.find('\t');
+        if (tab == std::string::npos) continue;
+        EntradaCatalogo e;
+        e.caminho = linha.substr(0, tab);
+        std::istringstream campos(linha.substr(tab + 1));
+        ResumoArvore& r = e.resumo;
+        campos >> e.tamanho >> e.modificacao >> r.dimensao >> e.nTerm >> e.step >> r.nPontos >> r.nSegmentos
+               >> r.minimo.x >> r.minimo.y >> r.minimo.z >> r.maximo.x >> r.maximo.y >> r.maximo.z >> r.raioMin >> r.raioMax;
+        if (campos.fail()) continue;   // linha corrompida: o arquivo é relido no próximo atualizar()
+        lista.push_back(e);
+    }
+    std::sort(lista.begin(), lista.end(), antes);
+    return true;
+}
+
+bool Catalogo::salvarIndice(const std::string& caminho) const {
+    std::error_code erro;
+    fs::path destino(caminho);
+    if (destino.has_parent_path()) fs::create_directories(destino.parent_path(), erro);
+    // Temporário + rename: outra instância nunca lê um índice pela metade
+    std::string temporario = caminho + ".tmp";
+    {
+        std::ofstream saida(temporario);
+        if (!saida.is_open()) {
+            std::cerr << "ERRO: Nao consegui criar " << temporario << std::endl;
+            return false;
+        }
+        saida.precision(9);
+        saida << CABECALHO_INDICE << '\n';
+        for (const EntradaCatalogo& e : lista) {
+            const ResumoArvore& r = e.resumo;
+            saida << e.caminho << '\t' << e.tamanho << '\t' << e.modificacao << '\t' << r.dimensao << '\t' << e.nTerm << '\t'
+                  << e.step << '\t' << r.nPontos << '\t' << r.nSegmentos << '\t' << r.minimo.x << ' ' << r.minimo.y << ' '
+                  << r.minimo.z << ' ' << r.maximo.x << ' ' << r.maximo.y << ' ' << r.maximo.z << '\t' << r.raioMin << '\t'
+                  << r.raioMax << '\n';
+        }
+        if (!saida) return false;
+    }
+    fs::rename(temporario, caminho, erro);
+    return !erro;
+}
+
+int Catalogo::atualizar(const std::vector<std::string>& raizes, int threads) {
+    RASTREIO_ESCOPO("atualizar catalogo");
+    std::unordered_map<std::string, size_t> antigas;
+    for (size_t i = 0; i < lista.size(); i++) antigas[lista[i].caminho] = i;
+
+    // 1. Só stat: o que existe agora e o que mudou desde o índice
+    std::vector<EntradaCatalogo> novas;
+    std::vector<size_t> reler;
+    for (const std::string& raiz : raizes) {
+        std::error_code erro;
+        fs::recursive_directory_iterator it(raiz, fs::directory_options::skip_permission_denied, erro), fim;
+        for (; !erro && it != fim; it.increment(erro)) {
+            if (!it->is_regular_file(erro) || !extensaoArvore(it->path())) continue;
+            EntradaCatalogo e;
+            e.caminho = fs::absolute(it->path(), erro).lexically_normal().string();
+            e.tamanho = it->file_size(erro);
+            e.modificacao = (int64_t)it->last_write_time(erro).time_since_epoch().count();
+            auto a = antigas.find(e.caminho);
+            if (a != antigas.end() && lista[a->second].tamanho == e.tamanho && lista[a->second].modificacao == e.modificacao) {
+                novas.push_back(lista[a->second]);
+                continue;
+            }
+            lerNomePacote(it->path().filename().string(), e.nTerm, e.step);
+            reler.push_back(novas.size());
+            novas.push_back(e);
+        }
+        if (erro) std::cerr << "ERRO: Nao consegui varrer " << raiz << ": " << erro.message() << std::endl;
+    }
+
+    // 2. Resumo dos arquivos novos ou alterados; os ilegíveis saem do catálogo
+    std::vector<char> ok(reler.size(), 0);
+    if (!reler.empty()) {
+        PoolTarefas pool(threads);
+        pool.paraCada((int)reler.size(), [&](int i) { ok[i] = lerResumoArvore(novas[reler[i]].caminho, novas[reler[i]].resumo); });
+    }
+    std::vector<char> manter(novas.size(), 1);
+    for (size_t i = 0; i < reler.size(); i++) manter[reler[i]] = ok[i];
+    lista.clear();
+    for (size_t i = 0; i < novas.size(); i++)
+        if (manter[i]) lista.push_back(std::move(novas[i]));
+    std::sort(lista.begin(), lista.end(), antes);
+    return (int)reler.size();
+}
+
+const EntradaCatalogo* Catalogo::procurar(int dimensao, int nTerm, int step) const {
+    for (const EntradaCatalogo& e : lista)
+        if (e.resumo.dimensao == dimensao && e.nTerm == nTerm && e.step == step) return &e;
+    return nullptr;
+}
+
+std::vector<int> Catalogo::nTerms(int dimensao) const {
+    std::vector<int> saida;
+    for (const EntradaCatalogo& e : lista)
+        if (e.resumo.dimensao == dimensao && e.nTerm >= 0 && (saida.empty() || saida.back() != e.nTerm)) saida.push_back(e.nTerm);
+    return saida;   // a lista já está ordenada por (dimensão, Nterm)
+}
+
+void Catalogo::listar(std::ostream& saida) const {
+    char linha[160];
+    saida << "dim  Nterm   step    pontos  segmentos      raio min      raio max  arquivo\n";
+    for (const EntradaCatalogo& e : lista) {
+        const ResumoArvore& r = e.resumo;
+        std::snprintf(linha, sizeof(linha), "%2dD  %5d  %5d  %8llu  %9llu  %12.5g  %12.5g  ", r.dimensao, e.nTerm, e.step,
+                      (unsigned long long)r.nPontos, (unsigned long long)r.nSegmentos, r.raioMin, r.raioMax);
+        saida << linha << e.caminho << '\n';
+    }
+    saida << lista.size() << " arvore(s)" << std::endl;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "carregador_vtk.h"
+
+// --- CATÁLOGO DE ÁRVORES ---
+// Varre as raízes de dados uma vez, guarda o resumo de cada árvore (contagens,
+// dimensão, caixa envolvente, faixa de raios) e persiste tudo num índice de
+// texto, uma linha por arquivo. Nas próximas execuções só o tamanho e a data
+// de cada arquivo são conferidos (stat); um arquivo só é lido de novo se mudou.
+// Listar e escolher entre centenas de árvores não abre nenhuma delas.
+//
+// Nterm e step vêm do nome no padrão do pacote (treeND_NtermXXXX_stepYYYY.vtk);
+// arquivos fora do padrão entram com -1 e continuam aparecendo na listagem.
+
+struct EntradaCatalogo {
+    std::string caminho;
+    uint64_t tamanho = 0;
+    int64_t modificacao = 0;        // data do arquivo (contagem do relógio do sistema de arquivos)
+    int nTerm = -1, step = -1;
+    ResumoArvore resumo;
+};
+
+class Catalogo {
+public:
+    // Índice salvo; false se não existe ou é de outra versão (o catálogo fica vazio)
+    bool carregarIndice(const std::string& caminho);
+    bool salvarIndice(const std::string& caminho) const;
+
+    // Sincroniza com o disco: entradas das raízes que mudaram são relidas (em
+    // paralelo), as que sumiram saem. Devolve quantos arquivos foram lidos.
+    int atualizar(const std::vector<std::string>& raizes, int threads = 0);
+
+    // nullptr se não houver
+    const EntradaCatalogo* procurar(int dimensao, int nTerm, int step) const;
+    // Nterm disponíveis para a dimensão (ordenados), para as mensagens de erro
+    std::vector<int> nTerms(int dimensao) const;
+
+    const std::vector<EntradaCatalogo>& entradas() const { return lista; }
+    void listar(std::ostream& saida) const;
+
+private:
+    std::vector<EntradaCatalogo> lista;   // ordenada por dimensão, Nterm, step, caminho
+};
+
+// Nterm e step de "tree2D_Nterm0256_step0224.vtk"; false fora do padrão
+bool lerNomePacote(const std::string& nomeArquivo, int& nTerm, int& step);
@@ -0,0 +1,322 @@
+#include "cco.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+uint64_t splitmix(uint64_t& estado) {
+    uint64_t z = (estado += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+float uniforme(uint64_t& estado) { return (splitmix(estado) >> 40) * (1.0f / (1 << 24)); }
+
+// Orientação de c em relação à reta a-b (só x, y)
+float orientacao(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+// Cruzamento próprio (não conta encostar nas pontas)
+bool cruzam2D(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d) {
+    float o1 = orientacao(a, b, c), o2 = orientacao(a, b, d);
+    float o3 = orientacao(c, d, a), o4 = orientacao(c, d, b);
+    return ((o1 > 0 && o2 < 0) || (o1 < 0 && o2 > 0)) && ((o3 > 0 && o4 < 0) || (o3 < 0 && o4 > 0));
+}
+
+} // namespace
+
+ArvoreCCO::ArvoreCCO(const ParametrosCCO& parametros) : prm(parametros) {
+    fatorResistencia = 8.0 * prm.viscosidade / PI;
+    rng = prm.semente;
+    distanciaCritica = 1.0f;
+    // Raiz no topo do domínio, como nos arquivos do pacote
+    raiz = glm::vec3(0.0f, prm.raioDominio, 0.0f);
+
+    float R = prm.raioDominio;
+    glm::vec3 minimo(-R, -R, prm.dimensao == 3 ? -R : 0.0f), maximo(R, R, prm.dimensao == 3 ? R : 0.0f);
+    float porEixo = prm.dimensao == 3 ? std::cbrt((float)prm.nTerminais) : std::sqrt((float)prm.nTerminais);
+    grade.configurar(minimo, maximo, 2.0f * R / std::max(1.0f, porEixo), prm.dimensao);
+    pool.reset(new PoolTarefas(prm.threads));
+}
+
+glm::vec3 ArvoreCCO::sortearPonto() {
+    float R = prm.raioDominio;
+    while (true) {
+        glm::vec3 p((2.0f * uniforme(rng) - 1.0f) * R, (2.0f * uniforme(rng) - 1.0f) * R,
+                    prm.dimensao == 3 ? (2.0f * uniforme(rng) - 1.0f) * R : 0.0f);
+        if (glm::length(p) <= R) return p;
+    }
+}
+
+bool ArvoreCCO::pontoValido(const glm::vec3& p, float distancia) {
+    return grade.distanciaMinima(p) > distancia;
+}
+
+void ArvoreCCO::betas(int nA, double rA, int nB, double rB, double& betaA, double& betaB) const {
+    // Fluxo proporcional ao número de terminais: rA/rB = (QA R*A / QB R*B)^(1/4)
+    // É a função mais chamada do crescimento; com gamma = 3 evita os pow
+    double q = (nA * rA) / (nB * rB);
+    if (prm.gamma == 3.0) {
+        double r = std::sqrt(std::sqrt(q)), x = r * r * r;
+        betaA = 1.0 / std::cbrt(1.0 + 1.0 / x);
+        betaB = 1.0 / std::cbrt(1.0 + x);
+        return;
+    }
+    double x = std::pow(q, prm.gamma / 4.0);   // (rA/rB)^gamma
+    betaA = std::pow(1.0 + 1.0 / x, -1.0 / prm.gamma);
+    betaB = std::pow(1.0 + x, -1.0 / prm.gamma);
+}
+
+// Volume da árvore se o terminal t for ligado ao segmento j pela bifurcação b.
+// Só o caminho de j até a raiz muda; o resto vem do que está guardado.
+ArvoreCCO::Avaliacao ArvoreCCO::avaliar(int j, const glm::vec3& b, const glm::vec3& t) const {
+    const SegmentoCCO& sj = segs[j];
+    const double k = fatorResistencia, minimo = 1e-7 * prm.raioDominio;
+    double lNovo = std::max<double>(glm::length(t - b), minimo);
+    double lDist = std::max<double>(glm::length(sj.distal - b), minimo);
+    double lProx = std::max<double>(glm::length(b - proximal(j)), minimo);
+
+    // Parte distal: herda os filhos de j
+    double rDist = k * lDist, vDist = PI * lDist;
+    if (sj.filhos[0] >= 0) {
+        const SegmentoCCO& f0 = segs[sj.filhos[0]];
+        const SegmentoCCO& f1 = segs[sj.filhos[1]];
+        rDist += 1.0 / (f0.beta * f0.beta * f0.beta * f0.beta / f0.resistencia + f1.beta * f1.beta * f1.beta * f1.beta / f1.resistencia);
+        vDist += f0.beta * f0.beta * f0.volumeRed + f1.beta * f1.beta * f1.volumeRed;
+    }
+    double rNovo = k * lNovo, vNovo = PI * lNovo;
+
+    double betaDist, betaNovo;
+    betas(sj.nTerminais, rDist, 1, rNovo, betaDist, betaNovo);
+    double rCur = k * lProx + 1.0 / (betaDist * betaDist * betaDist * betaDist / rDist + betaNovo * betaNovo * betaNovo * betaNovo / rNovo);
+    double vCur = PI * lProx + betaDist * betaDist * vDist + betaNovo * betaNovo * vNovo;
+    int nCur = sj.nTerminais + 1;
+
+    // Sobe até a raiz combinando com os irmãos
+    double produto = 1.0;
+    for (int cur = j; segs[cur].pai >= 0; cur = segs[cur].pai) {
+        const SegmentoCCO& pai = segs[segs[cur].pai];
+        const SegmentoCCO& irmao = segs[pai.filhos[0] == cur ? pai.filhos[1] : pai.filhos[0]];
+        double betaCur, betaIrmao;
+        betas(nCur, rCur, irmao.nTerminais, irmao.resistencia, betaCur, betaIrmao);
+        produto *= betaCur;
+        rCur = k * pai.comprimento + 1.0 / (betaCur * betaCur * betaCur * betaCur / rCur + betaIrmao * betaIrmao * betaIrmao * betaIrmao / irmao.resistencia);
+        vCur = PI * pai.comprimento + betaCur * betaCur * vCur + betaIrmao * betaIrmao * irmao.volumeRed;
+        nCur = pai.nTerminais + 1;
+    }
+
+    double raioRaiz = std::pow(prm.fluxoPerfusao * rCur / (prm.pressaoPerfusao - prm.pressaoTerminal), 0.25);
+    Avaliacao a;
+    a.volume = raioRaiz * raioRaiz * vCur;
+    a.raioProximal = raioRaiz * produto;
+    a.raioDistal = a.raioProximal * betaDist;
+    a.raioNovo = a.raioProximal * betaNovo;
+    return a;
+}
+
+// Ponto de Fermat ponderado por r^2 (volume ~ soma r^2 l), com os raios
+// reavaliados a cada iteração (Weiszfeld)
+bool ArvoreCCO::otimizarBifurcacao(int j, const glm::vec3& t, glm::vec3& melhorB, double& melhorVolume) const {
+    glm::vec3 x[3] = {proximal(j), segs[j].distal, t};
+    glm::vec3 b = (x[0] + x[1] + x[2]) / 3.0f;
+    melhorVolume = std::numeric_limits<double>::infinity();
+    for (int it = 0; it < prm.iteracoesBifurcacao; it++) {
+        Avaliacao a = avaliar(j, b, t);
+        if (a.volume < melhorVolume) { melhorVolume = a.volume; melhorB = b; }
+        double w[3] = {a.raioProximal * a.raioProximal, a.raioDistal * a.raioDistal, a.raioNovo * a.raioNovo};
+        glm::dvec3 num(0.0);
+        double den = 0.0;
+        for (int i = 0; i < 3; i++) {
+            double d = std::max<double>(glm::length(b - x[i]), 1e-9);
+            num += glm::dvec3(x[i].x, x[i].y, x[i].z) * (w[i] / d);
+            den += w[i] / d;
+        }
+        glm::vec3 novo((float)(num.x / den), (float)(num.y / den), (float)(num.z / den));
+        if (glm::length(novo - b) < 1e-6f * prm.raioDominio) break;
+        b = novo;
+    }
+    return std::isfinite(melhorVolume);
+}
+
+bool ArvoreCCO::cruza(int j, const glm::vec3& b, const glm::vec3& t) {
+    if (prm.dimensao != 2) return false;
+    // Segmentos que encostam em j pelas pontas não contam
+    const SegmentoCCO& sj = segs[j];
+    int ignorar[5] = {j, sj.pai, sj.filhos[0], sj.filhos[1], -1};
+    if (sj.pai >= 0) {
+        const SegmentoCCO& pai = segs[sj.pai];
+        ignorar[4] = pai.filhos[0] == j ? pai.filhos[1] : pai.filhos[0];
+    }
+    glm::vec3 novos[3][2] = {{proximal(j), b}, {b, sj.distal}, {b, t}};
+    for (auto& s : novos) {
+        grade.perto(s[0], s[1], vizinhos);
+        for (int id : vizinhos) {
+            if (std::find(std::begin(ignorar), std::end(ignorar), id) != std::end(ignorar)) continue;
+            if (cruzam2D(s[0], s[1], proximal(id), segs[id].distal)) return true;
+        }
+    }
+    return false;
+}
+
+void ArvoreCCO::conectar(int j, const glm::vec3& b, const glm::vec3& t) {
+    int d = (int)segs.size(), n = d + 1;
+    glm::vec3 p = proximal(j);
+
+    SegmentoCCO dist;
+    dist.distal = segs[j].distal;
+    dist.pai = j;
+    dist.filhos[0] = segs[j].filhos[0];
+    dist.filhos[1] = segs[j].filhos[1];
+    dist.nTerminais = segs[j].nTerminais;
+    dist.comprimento = glm::length(dist.distal - b);
+    for (int f : dist.filhos) if (f >= 0) segs[f].pai = d;
+
+    SegmentoCCO novo;
+    novo.distal = t;
+    novo.pai = j;
+    novo.comprimento = glm::length(t - b);
+
+    segs[j].distal = b;
+    segs[j].filhos[0] = d;
+    segs[j].filhos[1] = n;
+    segs[j].comprimento = glm::length(b - p);
+    segs.push_back(dist);
+    segs.push_back(novo);
+
+    grade.atualizar(j, p, b);
+    grade.inserir(d, b, dist.distal);
+    grade.inserir(n, b, t);
+    atualizarSegmento(n);
+    atualizarSegmento(d);
+    atualizarCaminho(j);
+}
+
+void ArvoreCCO::atualizarSegmento(int id) {
+    SegmentoCCO& s = segs[id];
+    const double k = fatorResistencia;
+    double l = std::max<double>(s.comprimento, 1e-7 * prm.raioDominio);
+    if (s.filhos[0] < 0) {
+        s.nTerminais = 1;
+        s.resistencia = k * l;
+        s.volumeRed = PI * l;
+        return;
+    }
+    SegmentoCCO& f0 = segs[s.filhos[0]];
+    SegmentoCCO& f1 = segs[s.filhos[1]];
+    betas(f0.nTerminais, f0.resistencia, f1.nTerminais, f1.resistencia, f0.beta, f1.beta);
+    s.nTerminais = f0.nTerminais + f1.nTerminais;
+    s.resistencia = k * l + 1.0 / (f0.beta * f0.beta * f0.beta * f0.beta / f0.resistencia + f1.beta * f1.beta * f1.beta * f1.beta / f1.resistencia);
+    s.volumeRed = PI * l + f0.beta * f0.beta * f0.volumeRed + f1.beta * f1.beta * f1.volumeRed;
+}
+
+void ArvoreCCO::atualizarCaminho(int id) {
+    // Fora do caminho nada muda: as subárvores dos irmãos mantêm R*, V* e a
+    // razão entre os filhos; só o beta delas em relação ao pai é refeito aqui
+    for (; id >= 0; id = segs[id].pai) atualizarSegmento(id);
+    segs[0].beta = 1.0;
+}
+
+double ArvoreCCO::raioRaiz() const {
+    return std::pow(prm.fluxoPerfusao * segs[0].resistencia / (prm.pressaoPerfusao - prm.pressaoTerminal), 0.25);
+}
+
+double ArvoreCCO::raio(int id) const {
+    double produto = 1.0;
+    for (; segs[id].pai >= 0; id = segs[id].pai) produto *= segs[id].beta;
+    return raioRaiz() * produto;
+}
+
+double ArvoreCCO::fluxo(int id) const {
+    return prm.fluxoPerfusao * segs[id].nTerminais / nTerminaisAtual;
+}
+
+double ArvoreCCO::volume() const {
+    if (segs.empty()) return 0.0;
+    double r = raioRaiz();
+    return r * r * segs[0].volumeRed;
+}
+
+bool ArvoreCCO::adicionarTerminal() {
+    if (nTerminaisAtual >= prm.nTerminais) return false;
+
+    // Distância crítica: raio da área (volume) que cada terminal "perfunde"
+    int k = nTerminaisAtual + 1;
+    float R = prm.raioDominio;
+    float base = prm.dimensao == 3 ? std::cbrt(4.0f / 3.0f * (float)PI * R * R * R / k)
+                                   : std::sqrt((float)PI * R * R / k);
+    for (int tentativas = 1; tentativas <= 100000; tentativas++) {
+        // Domínio cheio para esta distância: afrouxa aos poucos
+        if (tentativas % 1000 == 0) distanciaCritica *= 0.9f;
+        glm::vec3 t = sortearPonto();
+
+        if (segs.empty()) {
+            if (glm::length(t - raiz) <= base * distanciaCritica) continue;
+            SegmentoCCO s;
+            s.distal = t;
+            s.comprimento = glm::length(t - raiz);
+            segs.push_back(s);
+            grade.inserir(0, raiz, t);
+            atualizarCaminho(0);
+            nTerminaisAtual = 1;
+            return true;
+        }
+        if (!pontoValido(t, base * distanciaCritica)) continue;
+
+        grade.maisProximos(t, prm.candidatos, candidatos);
+        conexoes.resize(candidatos.size());
+        pool->paraCada((int)candidatos.size(), [&](int i) {
+            Conexao& c = conexoes[i];
+            c.ok = otimizarBifurcacao(candidatos[i], t, c.b, c.volume);
+        });
+
+        // Menor volume entre as que não cruzam nenhum vaso (empate fica com o
+        // candidato mais próximo); o cruzamento só é testado em quem melhoraria
+        int melhor = -1;
+        for (size_t i = 0; i < conexoes.size(); i++) {
+            if (!conexoes[i].ok || (melhor >= 0 && conexoes[i].volume >= conexoes[melhor].volume)) continue;
+            if (cruza(candidatos[i], conexoes[i].b, t)) continue;
+            melhor = (int)i;
+        }
+        // Toda conexão cruzaria algum vaso: sorteia outro ponto
+        if (melhor < 0) continue;
+
+        conectar(candidatos[melhor], conexoes[melhor].b, t);
+        nTerminaisAtual++;
+        return true;
+    }
+    return false;
+}
+
+Arvore2D ArvoreCCO::paraArvore() const {
+    Arvore2D arvore;
+    if (segs.empty()) return arvore;
+    arvore.vertices.resize(segs.size() + 1);
+    arvore.segmentos.resize(segs.size());
+    arvore.vertices[0].posicao = raiz;
+
+    // Raio de verdade: r_raiz * produto dos beta, de cima para baixo
+    std::vector<double> raios(segs.size());
+    raios[0] = raioRaiz();
+    std::vector<int> pilha = {0};
+    while (!pilha.empty()) {
+        int s = pilha.back(); pilha.pop_back();
+        for (int f : segs[s].filhos) if (f >= 0) { raios[f] = raios[s] * segs[f].beta; pilha.push_back(f); }
+    }
+
+    for (size_t i = 0; i < segs.size(); i++) {
+        arvore.vertices[i + 1].posicao = segs[i].distal;
+        Segmento& s = arvore.segmentos[i];
+        s.indicePontoA = segs[i].pai < 0 ? 0 : segs[i].pai + 1;
+        s.indicePontoB = (int)i + 1;
+        s.raio = (float)(raios[i] * prm.escalaRaio);
+        s.cor = glm::vec3((rand() % 100) / 100.0f, (rand() % 100) / 100.0f, (rand() % 100) / 100.0f);
+    }
+    return arvore;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "arvore.h"
+#include "grade_segmentos.h"
+#include "pool_tarefas.h"
+
+// --- CCO (Constrained Constructive Optimization) ---
+// Cresce a árvore um terminal por vez (Schreiner/Karch): sorteia um ponto no
+// domínio que respeite a distância mínima, testa a conexão com os segmentos
+// vizinhos (busca na grade), otimiza o ponto de bifurcação de cada conexão e
+// fica com a que der o menor volume total. Raios seguem Poiseuille + Murray.
+//
+// Por segmento guardamos só grandezas da subárvore (resistência reduzida R*,
+// volume reduzido V* e a razão beta entre o raio dele e o do pai). O raio de
+// verdade é r_raiz * produto dos beta até a raiz e o fluxo é Q * n / N, então
+// raio e fluxo absolutos nunca são reescritos: ao ligar um terminal, só R*, V*
+// e beta do caminho até a raiz mudam, em O(profundidade).
+//
+// Os candidatos de cada terminal são avaliados em paralelo (PoolTarefas). A
+// avaliação não escreve na árvore: os valores novos do caminho até a raiz
+// ficam em variáveis locais, por cima do estado guardado, e só a conexão
+// vencedora é aplicada. O resultado não depende do número de threads.
+
+struct ParametrosCCO {
+    int dimensao = 2;
+    int nTerminais = 256;
+    float raioDominio = 0.05f;           // círculo (2D) ou esfera (3D), em m
+    double fluxoPerfusao = 8.33e-6;      // m^3/s
+    double pressaoPerfusao = 1.33e4;     // Pa
+    double pressaoTerminal = 8.38e3;     // Pa
+    double viscosidade = 3.6e-3;         // Pa.s
+    double gamma = 3.0;                  // expoente de Murray
+    int candidatos = 20;                 // segmentos vizinhos testados por terminal
+    int iteracoesBifurcacao = 8;
+    float escalaRaio = 1000.0f;          // raios exportados em mm, como no pacote
+    uint64_t semente = 1;
+    int threads = 0;                     // avaliação dos candidatos; 0 = todos os núcleos
+};
+
+class ArvoreCCO {
+public:
+    explicit ArvoreCCO(const ParametrosCCO& parametros);
+
+    // Adiciona um terminal; false se não achou lugar válido
+    bool adicionarTerminal();
+    int terminais() const { return nTerminaisAtual; }
+    int segmentos() const { return (int)segs.size(); }
+    double volume() const;   // volume total da árvore, em m^3
+    double raio(int s) const;   // em m, O(profundidade)
+    double fluxo(int s) const;  // em m^3/s
+
+    // Vértice 0 = início da raiz, vértice i+1 = fim do segmento i (layout dos arquivos do pacote)
+    Arvore2D paraArvore() const;
+
+private:
+    struct SegmentoCCO {
+        glm::vec3 distal;
+        int pai = -1;
+        int filhos[2] = {-1, -1};
+        int nTerminais = 1;
+        double comprimento = 0.0;
+        double resistencia = 0.0;   // R* (resistência reduzida da subárvore)
+        double volumeRed = 0.0;     // V* (volume da subárvore / r^2)
+        double beta = 1.0;          // r_segmento / r_pai
+    };
+
+    // Resultado da avaliação de uma conexão candidata
+    struct Avaliacao {
+        double volume = 0.0;
+        double raioProximal = 0.0, raioDistal = 0.0, raioNovo = 0.0;
+    };
+
+    // Melhor bifurcação achada para um candidato
+    struct Conexao {
+        glm::vec3 b;
+        double volume;
+        bool ok;
+    };
+
+    glm::vec3 proximal(int s) const { return segs[s].pai < 0 ? raiz : segs[segs[s].pai].distal; }
+    glm::vec3 sortearPonto();
+    bool pontoValido(const glm::vec3& p, float distanciaCritica);
+    void betas(int nA, double rA, int nB, double rB, double& betaA, double& betaB) const;
+    Avaliacao avaliar(int j, const glm::vec3& b, const glm::vec3& t) const;
+    bool otimizarBifurcacao(int j, const glm::vec3& t, glm::vec3& melhorB, double& melhorVolume) const;
+    bool cruza(int j, const glm::vec3& b, const glm::vec3& t);
+    void conectar(int j, const glm::vec3& b, const glm::vec3& t);
+    void atualizarSegmento(int s);   // R*, V* de s e beta dos filhos, a partir dos filhos
+    void atualizarCaminho(int s);    // atualizarSegmento de s até a raiz
+    double raioRaiz() const;
+
+    ParametrosCCO prm;
+    std::vector<SegmentoCCO> segs;
+    glm::vec3 raiz;
+    GradeSegmentos grade;
+    int nTerminaisAtual = 0;
+    double fatorResistencia;   // 8 mu / pi
+    uint64_t rng;
+    float distanciaCritica;
+    std::vector<int> vizinhos;
+    std::vector<int> candidatos;
+    std::vector<Conexao> conexoes;
+    std::unique_ptr<PoolTarefas> pool;
+};
@@ -0,0 +1,117 @@
+#include "consulta_caminhos.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "pool_tarefas.h"
+#include "rastreio.h"
+
+namespace {
+
+const int GRAO = 16384;
+
+} // namespace
+
+void ConsultaCaminhos::montar(const Arvore2D& arvore, const Topologia& topo, const std::vector<float>* resist,
+                              PoolTarefas& pool) {
+    RASTREIO_ESCOPO("ConsultaCaminhos::montar");
+    n = topo.nSegmentos();
+    pai = topo.pai;
+    profundidade = topo.profundidade;
+    comprimento.resize(n);
+    resistencia.assign(n, 0.0);
+    const auto& segs = arvore.segmentos;
+    const auto& verts = arvore.vertices;
+    pool.paraBlocos(n, GRAO, [&](int i0, int i1) {
+        for (int s = i0; s < i1; s++) {
+            comprimento[s] = glm::length(verts[segs[s].indicePontoB].posicao - verts[segs[s].indicePontoA].posicao);
+            if (resist) resistencia[s] = (*resist)[s];
+        }
+    });
+
+    // Somas da raiz até cada segmento, nível a nível
+    somaComprimento.assign(n, 0.0);
+    somaResistencia.assign(n, 0.0);
+    somaInfinitas.assign(n, 0);
+    for (int nivel = 0; nivel < topo.nNiveis(); nivel++) {
+        const int* ordem = topo.ordem.data() + topo.inicioNivel[nivel];
+        pool.paraBlocos(topo.inicioNivel[nivel + 1] - topo.inicioNivel[nivel], GRAO, [&](int i0, int i1) {
+            for (int i = i0; i < i1; i++) {
+                int s = ordem[i], p = pai[s];
+                somaComprimento[s] = comprimento[s] + (p >= 0 ? somaComprimento[p] : 0.0);
+                bool infinita = std::isinf(resistencia[s]);
+                somaResistencia[s] = (infinita ? 0.0 : resistencia[s]) + (p >= 0 ? somaResistencia[p] : 0.0);
+                somaInfinitas[s] = (infinita ? 1 : 0) + (p >= 0 ? somaInfinitas[p] : 0);
+            }
+        });
+    }
+
+    // Tabela de saltos: só o necessário para cobrir a maior profundidade
+    int maxProf = 0;
+    for (int p : profundidade) maxProf = std::max(maxProf, p);
+    niveis = 1;
+    while ((1 << niveis) <= maxProf) niveis++;
+    subida.resize((size_t)niveis * n);
+    std::copy(pai.begin(), pai.end(), subida.begin());
+    for (int k = 1; k < niveis; k++) {
+        const int* anterior = subida.data() + (size_t)(k - 1) * n;
+        int* atual = subida.data() + (size_t)k * n;
+        pool.paraBlocos(n, GRAO, [&](int i0, int i1) {
+            for (int s = i0; s < i1; s++) atual[s] = anterior[s] < 0 ? -1 : anterior[anterior[s]];
+        });
+    }
+}
+
+int ConsultaCaminhos::ancestral(int s, int geracoes) const {
+    if (geracoes < 0) return -1;
+    for (int k = 0; geracoes && s >= 0; k++, geracoes >>= 1) {
+        if (k >= niveis) return -1;
+        if (geracoes & 1) s = subida[(size_t)k * n + s];
+    }
+    return s;
+}
+
+int ConsultaCaminhos::ancestralComum(int a, int b) const {
+    if (a < 0 || b < 0 || a >= n || b >= n || profundidade[a] < 0 || profundidade[b] < 0) return -1;
+    if (profundidade[a] < profundidade[b]) std::swap(a, b);
+    a = ancestral(a, profundidade[a] - profundidade[b]);
+    if (a == b) return a;
+    for (int k = niveis - 1; k >= 0; k--) {
+        int ua = subida[(size_t)k * n + a], ub = subida[(size_t)k * n + b];
+        if (ua != ub) { a = ua; b = ub; }
+    }
+    return pai[a];   // -1 se forem raízes diferentes
+}
+
+ConsultaCaminhos::Caminho ConsultaCaminhos::caminho(int a, int b) const {
+    Caminho c;
+    c.ancestral = ancestralComum(a, b);
+    if (c.ancestral < 0) return c;
+    int m = c.ancestral;
+    bool incluiAncestral = m == a || m == b;
+    c.segmentos = profundidade[a] + profundidade[b] - 2 * profundidade[m] + (incluiAncestral ? 1 : 0);
+    c.comprimento = somaComprimento[a] + somaComprimento[b] - 2.0 * somaComprimento[m] +
+                    (incluiAncestral ? comprimento[m] : 0.0);
+    int infinitas = somaInfinitas[a] + somaInfinitas[b] - 2 * somaInfinitas[m] +
+                    (incluiAncestral && std::isinf(resistencia[m]) ? 1 : 0);
+    if (infinitas > 0) c.resistencia = std::numeric_limits<double>::infinity();
+    else c.resistencia = somaResistencia[a] + somaResistencia[b] - 2.0 * somaResistencia[m] +
+                         (incluiAncestral ? resistencia[m] : 0.0);
+    return c;
+}
+
+double ConsultaCaminhos::resistenciaAteRaiz(int s) const {
+    return somaInfinitas[s] > 0 ? std::numeric_limits<double>::infinity() : somaResistencia[s];
+}
+
+void ConsultaCaminhos::segmentosDoCaminho(int a, int b, std::vector<int>& saida) const {
+    saida.clear();
+    int m = ancestralComum(a, b);
+    if (m < 0) return;
+    for (int s = a; s != m; s = pai[s]) saida.push_back(s);
+    if (m == a || m == b) saida.push_back(m);
+    size_t meio = saida.size();
+    for (int s = b; s != m; s = pai[s]) saida.push_back(s);
+    std::reverse(saida.begin() + meio, saida.end());
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <memory_resource>
+#include <vector>
+
+#include "arvore.h"
+#include "topologia.h"
+
+class PoolTarefas;
+
+// --- CONSULTAS DE CAMINHO (binary lifting) ---
+// Montada uma vez por árvore: para cada segmento guarda os ancestrais a
+// 1, 2, 4, ... gerações (só até a profundidade máxima da árvore, não log n)
+// e as somas de comprimento e resistência da raiz até ele. Com isso o
+// ancestral comum sai em O(log profundidade) e comprimento/resistência do
+// caminho entre dois vasos em O(1) depois dele.
+//
+// O caminho entre a e b tem os segmentos de a e b e todos entre eles; o
+// ancestral comum só entra se for o próprio a ou b (senão o caminho passa
+// pela bifurcação no fim dele, sem percorrê-lo).
+//
+// Resistência infinita (raio 0) não cabe numa soma de prefixos (inf - inf):
+// a soma leva só as finitas e uma contagem à parte diz quantas infinitas há
+// da raiz até cada segmento; com alguma no caminho, a resistência é infinita.
+class ConsultaCaminhos {
+public:
+    struct Caminho {
+        int ancestral = -1;       // -1: a e b estão em árvores diferentes
+        int segmentos = 0;
+        double comprimento = 0.0;
+        double resistencia = 0.0; // soma em série das resistências do caminho
+    };
+
+    // As tabelas saem de 'recurso' (ex.: a arena da árvore consultada)
+    explicit ConsultaCaminhos(std::pmr::memory_resource* recurso = std::pmr::get_default_resource())
+        : subida(recurso), profundidade(recurso), pai(recurso), comprimento(recurso), resistencia(recurso),
+          somaComprimento(recurso), somaResistencia(recurso), somaInfinitas(recurso) {}
+
+    // 'resistencia' é opcional (um valor por segmento, ex.: Hemodinamica::resistencia)
+    void montar(const Arvore2D& arvore, const Topologia& topo, const std::vector<float>* resistencia,
+                PoolTarefas& pool);
+
+    int ancestralComum(int a, int b) const;
+    int ancestral(int s, int geracoes) const;   // -1 se passar da raiz
+    Caminho caminho(int a, int b) const;
+    // Segmentos do caminho, de a até b
+    void segmentosDoCaminho(int a, int b, std::vector<int>& saida) const;
+
+    double comprimentoAteRaiz(int s) const { return somaComprimento[s]; }
+    double resistenciaAteRaiz(int s) const;
+
+private:
+    int niveis = 0;                      // saltos de 2^0 .. 2^(niveis-1)
+    int n = 0;
+    std::pmr::vector<int> subida;        // subida[k * n + s] = ancestral 2^k gerações acima
+    std::pmr::vector<int> profundidade, pai;
+    std::pmr::vector<double> comprimento, resistencia;
+    std::pmr::vector<double> somaComprimento, somaResistencia;   // da raiz até s, inclusive (só as finitas)
+    std::pmr::vector<int> somaInfinitas;                         // resistências infinitas da raiz até s
+};
@@ -0,0 +1,131 @@
+#include "escritor_vtk.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+#include "rastreio.h"
+
+namespace {
+
+// Legacy VTK binário é big-endian
+void escreverBigEndian(FILE* f, const void* dados, size_t n) {
+    const uint32_t* v = (const uint32_t*)dados;
+    std::vector<uint32_t> buf(std::min<size_t>(n, 1 << 20));
+    for (size_t ini = 0; ini < n; ini += buf.size()) {
+        size_t k = std::min(buf.size(), n - ini);
+        for (size_t i = 0; i < k; i++) buf[i] = __builtin_bswap32(v[ini + i]);
+        std::fwrite(buf.data(), sizeof(uint32_t), k, f);
+    }
+}
+
+// Formata [0, n) em blocos, cada bloco numa thread, e grava na ordem
+void escreverTextoParalelo(FILE* f, size_t n, int threads,
+                           const std::function<void(size_t, size_t, std::string&)>& formatar) {
+    const size_t porBloco = 1 << 18;
+    if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> blocos(threads);
+    for (size_t ini = 0; ini < n; ini += porBloco * threads) {
+        std::vector<std::thread> ts;
+        for (int t = 0; t < threads; t++) {
+            size_t a = ini + t * porBloco, b = std::min(n, a + porBloco);
+            blocos[t].clear();
+            if (a >= b) continue;
+            if (t == threads - 1 || b == n) formatar(a, b, blocos[t]);
+            else ts.emplace_back([&, a, b, t]() { formatar(a, b, blocos[t]); });
+        }
+        for (auto& th : ts) th.join();
+        for (const auto& s : blocos) std::fwrite(s.data(), 1, s.size(), f);
+    }
+}
+
+void anexarFloat(std::string& s, float v) {
+    char buf[32];
+    int k = std::snprintf(buf, sizeof(buf), "%.7f", v);
+    s.append(buf, k);
+}
+
+} // namespace
+
+bool salvarVTKBruto(const std::string& caminho, FormatoVTK formato,
+                    const float* pos, size_t nVertices,
+                    const int32_t* indices, size_t nSegmentos,
+                    const std::vector<CampoCelula>& campos, int threads) {
+    RASTREIO_ESCOPO("salvarVTK");
+    FILE* f = std::fopen(caminho.c_str(), "wb");
+    if (!f) {
+        std::cerr << "ERRO: Nao consegui criar " << caminho << std::endl;
+        return false;
+    }
+    bool binario = formato == FormatoVTK::Binario;
+    std::fprintf(f, "# vtk DataFile Version 3.0\nvtk output\n%s\nDATASET POLYDATA\n", binario ? "BINARY" : "ASCII");
+
+    std::fprintf(f, "POINTS  %zu  float\n", nVertices);
+    if (binario) escreverBigEndian(f, pos, nVertices * 3);
+    else escreverTextoParalelo(f, nVertices, threads, [&](size_t a, size_t b, std::string& s) {
+        for (size_t i = a; i < b; i++) {
+            anexarFloat(s, pos[3*i]); s += "  ";
+            anexarFloat(s, pos[3*i+1]); s += "  ";
+            anexarFloat(s, pos[3*i+2]); s += '\n';
+        }
+    });
+
+    std::fprintf(f, "\nLINES  %zu  %zu\n", nSegmentos, nSegmentos * 3);
+    if (binario) {
+        std::vector<int32_t> celulas(nSegmentos * 3);
+        for (size_t i = 0; i < nSegmentos; i++) {
+            celulas[3*i] = 2; celulas[3*i+1] = indices[2*i]; celulas[3*i+2] = indices[2*i+1];
+        }
+        escreverBigEndian(f, celulas.data(), celulas.size());
+    } else {
+        escreverTextoParalelo(f, nSegmentos, threads, [&](size_t a, size_t b, std::string& s) {
+            char buf[48];
+            for (size_t i = a; i < b; i++) {
+                int k = std::snprintf(buf, sizeof(buf), "2  %d  %d\n", indices[2*i], indices[2*i+1]);
+                s.append(buf, k);
+            }
+        });
+    }
+
+    if (!campos.empty()) std::fprintf(f, "\nCELL_DATA  %zu\n", nSegmentos);
+    for (const auto& campo : campos) {
+        // minúsculo como nos arquivos do pacote (o parser original só ignora "scalars")
+        std::fprintf(f, "scalars %s float\nLOOKUP_TABLE default\n", campo.nome.c_str());
+        if (binario) {
+            escreverBigEndian(f, campo.valores, nSegmentos);
+            std::fputc('\n', f);
+        } else {
+            escreverTextoParalelo(f, nSegmentos, threads, [&](size_t a, size_t b, std::string& s) {
+                for (size_t i = a; i < b; i++) { anexarFloat(s, campo.valores[i]); s += '\n'; }
+            });
+        }
+    }
+
+    bool ok = std::ferror(f) == 0;
+    std::fclose(f);
+    if (!ok) std::cerr << "ERRO: falha ao gravar " << caminho << std::endl;
+    return ok;
+}
+
+bool salvarVTK(const Arvore2D& arvore, const std::string& caminho, FormatoVTK formato,
+               const std::vector<CampoCelula>& extras) {
+    std::vector<float> pos(arvore.vertices.size() * 3);
+    for (size_t i = 0; i < arvore.vertices.size(); i++) {
+        const glm::vec3& p = arvore.vertices[i].posicao;
+        pos[3*i] = p.x; pos[3*i+1] = p.y; pos[3*i+2] = p.z;
+    }
+    std::vector<int32_t> indices(arvore.segmentos.size() * 2);
+    std::vector<float> raios(arvore.segmentos.size());
+    for (size_t i = 0; i < arvore.segmentos.size(); i++) {
+        indices[2*i] = arvore.segmentos[i].indicePontoA;
+        indices[2*i+1] = arvore.segmentos[i].indicePontoB;
+        raios[i] = arvore.segmentos[i].raio;
+    }
+    std::vector<CampoCelula> campos = {{"raio", raios.data()}};
+    campos.insert(campos.end(), extras.begin(), extras.end());
+    return salvarVTKBruto(caminho, formato, pos.data(), arvore.vertices.size(),
+                          indices.data(), arvore.segmentos.size(), campos);
+}
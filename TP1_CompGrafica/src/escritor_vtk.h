@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "arvore.h"
+
+// --- ESCRITOR VTK (legacy POLYDATA) ---
+// Mesmo layout dos arquivos do pacote: POINTS, LINES com 2 índices e os
+// escalares por segmento em CELL_DATA (o primeiro campo é sempre "raio").
+
+enum class FormatoVTK { ASCII, Binario };
+
+struct CampoCelula {
+    std::string nome;
+    const float* valores;   // um por segmento
+};
+
+// Arrays crus, para quem gera milhões de segmentos sem passar por Arvore2D:
+// pos = 3 floats por vértice, indices = 2 por segmento.
+// O texto ASCII é formatado em paralelo por 'threads' threads (0 = todas).
+bool salvarVTKBruto(const std::string& caminho, FormatoVTK formato,
+                    const float* pos, size_t nVertices,
+                    const int32_t* indices, size_t nSegmentos,
+                    const std::vector<CampoCelula>& campos, int threads = 0);
+
+bool salvarVTK(const Arvore2D& arvore, const std::string& caminho,
+               FormatoVTK formato = FormatoVTK::ASCII,
+               const std::vector<CampoCelula>& extras = {});
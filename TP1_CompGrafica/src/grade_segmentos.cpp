@@ -0,0 +1,116 @@
+#include "grade_segmentos.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+void GradeSegmentos::configurar(const glm::vec3& minimo, const glm::vec3& maximo, float ladoCelula, int dim) {
+    dimensao = dim;
+    origem = minimo;
+    lado = std::max(ladoCelula, 1e-9f);
+    glm::vec3 extensao = maximo - minimo;
+    n.x = std::max(1, (int)std::ceil(extensao.x / lado));
+    n.y = std::max(1, (int)std::ceil(extensao.y / lado));
+    n.z = dimensao == 3 ? std::max(1, (int)std::ceil(extensao.z / lado)) : 1;
+    celulas.assign((size_t)n.x * n.y * n.z, {});
+    pontoA.clear(); pontoB.clear(); caixaMin.clear(); caixaMax.clear(); presente.clear(); marca.clear();
+}
+
+glm::ivec3 GradeSegmentos::celula(const glm::vec3& p) const {
+    glm::ivec3 c((int)std::floor((p.x - origem.x) / lado),
+                 (int)std::floor((p.y - origem.y) / lado),
+                 dimensao == 3 ? (int)std::floor((p.z - origem.z) / lado) : 0);
+    c.x = std::max(0, std::min(n.x - 1, c.x));
+    c.y = std::max(0, std::min(n.y - 1, c.y));
+    c.z = std::max(0, std::min(n.z - 1, c.z));
+    return c;
+}
+
+template <typename F>
+void GradeSegmentos::visitarCaixa(const glm::ivec3& c0, const glm::ivec3& c1, F f) {
+    for (int z = c0.z; z <= c1.z; z++)
+        for (int y = c0.y; y <= c1.y; y++)
+            for (int x = c0.x; x <= c1.x; x++) f(celulas[indice(x, y, z)]);
+}
+
+void GradeSegmentos::inserir(int id, const glm::vec3& a, const glm::vec3& b) {
+    if ((size_t)id >= presente.size()) {
+        size_t novo = (size_t)id + 1;
+        pontoA.resize(novo); pontoB.resize(novo); caixaMin.resize(novo); caixaMax.resize(novo);
+        presente.resize(novo, 0); marca.resize(novo, 0);
+    }
+    pontoA[id] = a; pontoB[id] = b;
+    caixaMin[id] = celula(glm::min(a, b));
+    caixaMax[id] = celula(glm::max(a, b));
+    presente[id] = 1;
+    visitarCaixa(caixaMin[id], caixaMax[id], [&](std::vector<int>& c) { c.push_back(id); });
+}
+
+void GradeSegmentos::remover(int id) {
+    if ((size_t)id >= presente.size() || !presente[id]) return;
+    visitarCaixa(caixaMin[id], caixaMax[id], [&](std::vector<int>& c) {
+        auto it = std::find(c.begin(), c.end(), id);
+        if (it != c.end()) { *it = c.back(); c.pop_back(); }
+    });
+    presente[id] = 0;
+}
+
+float GradeSegmentos::distanciaPontoSegmento(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b) {
+    glm::vec3 ab = b - a;
+    float l2 = glm::dot(ab, ab);
+    float t = l2 > 0.0f ? std::max(0.0f, std::min(1.0f, glm::dot(p - a, ab) / l2)) : 0.0f;
+    return glm::length(p - (a + ab * t));
+}
+
+void GradeSegmentos::maisProximos(const glm::vec3& p, int k, std::vector<int>& saida) {
+    saida.clear();
+    if (k <= 0) return;
+    consulta++;
+    // Max-heap com os k melhores até agora
+    std::priority_queue<std::pair<float, int>> melhores;
+    glm::ivec3 c = celula(p);
+    int maxAnel = std::max(n.x, std::max(n.y, n.z));
+    for (int anel = 0; anel <= maxAnel; anel++) {
+        // Tudo além deste anel está a pelo menos (anel - 1) * lado de p
+        if ((int)melhores.size() == k && melhores.top().first < (anel - 1) * lado) break;
+        glm::ivec3 c0 = c - glm::ivec3(anel), c1 = c + glm::ivec3(anel);
+        if (dimensao == 2) { c0.z = 0; c1.z = 0; }
+        for (int z = std::max(0, c0.z); z <= std::min(n.z - 1, c1.z); z++)
+            for (int y = std::max(0, c0.y); y <= std::min(n.y - 1, c1.y); y++)
+                for (int x = std::max(0, c0.x); x <= std::min(n.x - 1, c1.x); x++) {
+                    // Só a casca do anel
+                    bool casca = x == c0.x || x == c1.x || y == c0.y || y == c1.y ||
+                                 (dimensao == 3 && (z == c0.z || z == c1.z));
+                    if (!casca) continue;
+                    for (int id : celulas[indice(x, y, z)]) {
+                        if (marca[id] == consulta) continue;
+                        marca[id] = consulta;
+                        float d = distanciaPontoSegmento(p, pontoA[id], pontoB[id]);
+                        if ((int)melhores.size() < k) melhores.push({d, id});
+                        else if (d < melhores.top().first) { melhores.pop(); melhores.push({d, id}); }
+                    }
+                }
+    }
+    saida.resize(melhores.size());
+    for (int i = (int)saida.size() - 1; i >= 0; i--) { saida[i] = melhores.top().second; melhores.pop(); }
+}
+
+float GradeSegmentos::distanciaMinima(const glm::vec3& p) {
+    std::vector<int> um;
+    maisProximos(p, 1, um);
+    if (um.empty()) return std::numeric_limits<float>::infinity();
+    return distanciaPontoSegmento(p, pontoA[um[0]], pontoB[um[0]]);
+}
+
+void GradeSegmentos::perto(const glm::vec3& a, const glm::vec3& b, std::vector<int>& saida) {
+    saida.clear();
+    consulta++;
+    visitarCaixa(celula(glm::min(a, b)), celula(glm::max(a, b)), [&](std::vector<int>& c) {
+        for (int id : c) {
+            if (marca[id] == consulta) continue;
+            marca[id] = consulta;
+            saida.push_back(id);
+        }
+    });
+}
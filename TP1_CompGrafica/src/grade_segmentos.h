@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// --- GRADE UNIFORME SOBRE SEGMENTOS ---
+// Cada segmento é registrado em todas as células que a sua caixa envolvente toca.
+// A busca dos k mais próximos anda em anéis a partir da célula do ponto e para
+// assim que o anel seguinte não pode ter nada mais perto, então custa O(k) em
+// árvores com densidade uniforme, e não O(n).
+class GradeSegmentos {
+public:
+    // Cobre a caixa [minimo, maximo] com células de lado ~'lado' (em 2D, z é ignorado)
+    void configurar(const glm::vec3& minimo, const glm::vec3& maximo, float lado, int dimensao);
+
+    void inserir(int id, const glm::vec3& a, const glm::vec3& b);
+    void remover(int id);
+    void atualizar(int id, const glm::vec3& a, const glm::vec3& b) { remover(id); inserir(id, a, b); }
+
+    // Até k segmentos mais próximos de p, do mais perto ao mais longe
+    void maisProximos(const glm::vec3& p, int k, std::vector<int>& saida);
+    // Menor distância de p a qualquer segmento (infinito se a grade estiver vazia)
+    float distanciaMinima(const glm::vec3& p);
+    // Segmentos cujas células tocam a caixa de a-b (candidatos a interseção)
+    void perto(const glm::vec3& a, const glm::vec3& b, std::vector<int>& saida);
+
+    static float distanciaPontoSegmento(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b);
+
+private:
+    glm::ivec3 celula(const glm::vec3& p) const;
+    int indice(int x, int y, int z) const { return (z * n.y + y) * n.x + x; }
+    template <typename F> void visitarCaixa(const glm::ivec3& c0, const glm::ivec3& c1, F f);
+
+    glm::vec3 origem;
+    float lado = 1.0f;
+    glm::ivec3 n;
+    int dimensao = 2;
+    std::vector<std::vector<int>> celulas;
+    std::vector<glm::vec3> pontoA, pontoB;
+    std::vector<glm::ivec3> caixaMin, caixaMax;   // células ocupadas por segmento
+    std::vector<uint8_t> presente;
+    std::vector<uint32_t> marca;                  // evita visitar o mesmo segmento duas vezes
+    uint32_t consulta = 0;
+};
@@ -0,0 +1,148 @@
+#include "hemodinamica.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "pool_tarefas.h"
+#include "rastreio.h"
+#include "topologia.h"
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+const int GRAO = 16384;   // abaixo disso um nível roda em série
+
+} // namespace
+
+std::vector<CampoCelula> Hemodinamica::campos() const {
+    return {{"resistencia", resistencia.data()}, {"resistencia_eq", resistenciaEq.data()},
+            {"fluxo", fluxo.data()}, {"pressao_proximal", pressaoProximal.data()},
+            {"pressao_distal", pressaoDistal.data()}};
+}
+
+Hemodinamica resolverHemodinamica(const Arvore2D& arvore, const ParametrosHemodinamica& prm, int threads) {
+    PoolTarefas pool(threads);
+    return resolverHemodinamica(arvore, montarTopologia(arvore, pool), prm, pool);
+}
+
+Hemodinamica resolverHemodinamica(const Arvore2D& arvore, const Topologia& topo,
+                                  const ParametrosHemodinamica& prm, PoolTarefas& pool) {
+    RASTREIO_ESCOPO("resolverHemodinamica");
+    const auto& segs = arvore.segmentos;
+    const auto& verts = arvore.vertices;
+    int n = (int)segs.size();
+    Hemodinamica h;
+    h.resistencia.assign(n, 0.0f);
+    h.resistenciaEq.assign(n, 0.0f);
+    h.fluxo.assign(n, 0.0f);
+    h.pressaoProximal.assign(n, 0.0f);
+    h.pressaoDistal.assign(n, 0.0f);
+    if (n == 0) return h;
+
+    // 1. Poiseuille por segmento e volume (soma parcial por bloco)
+    std::vector<double> volumes((n + GRAO - 1) / GRAO, 0.0);
+    const double k = 8.0 * prm.viscosidade / PI;
+    pool.paraBlocos(n, GRAO, [&](int i0, int i1) {
+        double v = 0.0;
+        for (int s = i0; s < i1; s++) {
+            double l = glm::length(verts[segs[s].indicePontoB].posicao - verts[segs[s].indicePontoA].posicao);
+            double r = segs[s].raio * prm.escalaRaio;
+            h.resistencia[s] = r > 0.0 ? (float)(k * l / (r * r * r * r)) : std::numeric_limits<float>::infinity();
+            v += PI * r * r * l;
+        }
+        volumes[i0 / GRAO] = v;
+    });
+    for (double v : volumes) h.volumeTotal += v;
+
+    // 2. Resistência equivalente, do nível mais fundo para a raiz (filhos em paralelo)
+    int nNiveis = topo.nNiveis();
+    {
+        RASTREIO_ESCOPO("hemodinamica: subida");
+        for (int nivel = nNiveis - 1; nivel >= 0; nivel--) {
+            const int* ordem = topo.ordem.data() + topo.inicioNivel[nivel];
+            pool.paraBlocos(topo.inicioNivel[nivel + 1] - topo.inicioNivel[nivel], GRAO, [&](int i0, int i1) {
+                for (int i = i0; i < i1; i++) {
+                    int s = ordem[i];
+                    double g = 0.0;
+                    for (int c = 0; c < topo.nFilhos(s); c++) g += 1.0 / h.resistenciaEq[topo.filhosDe(s)[c]];
+                    // Filhos todos bloqueados (g = 0): o segmento também não leva fluxo.
+                    // Filho sem resistência (g = inf): 1/g = 0, só a do próprio segmento
+                    if (topo.nFilhos(s) == 0) h.resistenciaEq[s] = h.resistencia[s];
+                    else h.resistenciaEq[s] = g > 0.0 ? (float)(h.resistencia[s] + 1.0 / g) : std::numeric_limits<float>::infinity();
+                }
+            });
+        }
+    }
+
+    // 3. Fluxo e pressões, da raiz para baixo: o fluxo se divide na proporção
+    //    da condutância equivalente de cada filho (terminais na mesma pressão)
+    {
+        RASTREIO_ESCOPO("hemodinamica: descida");
+        double deltaP = prm.pressaoRaiz - prm.pressaoTerminal;
+        for (int s : topo.raizes) {
+            // Comprimento zero da raiz aos terminais: sem resistência, sem solução finita; fica com fluxo 0
+            h.fluxo[s] = h.resistenciaEq[s] > 0.0f ? (float)(deltaP / h.resistenciaEq[s]) : 0.0f;
+            h.pressaoProximal[s] = (float)prm.pressaoRaiz;
+            h.fluxoTotal += h.fluxo[s];
+        }
+        for (int nivel = 0; nivel < nNiveis; nivel++) {
+            const int* ordem = topo.ordem.data() + topo.inicioNivel[nivel];
+            pool.paraBlocos(topo.inicioNivel[nivel + 1] - topo.inicioNivel[nivel], GRAO, [&](int i0, int i1) {
+                for (int i = i0; i < i1; i++) {
+                    int s = ordem[i];
+                    double q = h.fluxo[s];
+                    // Raio 0: vaso bloqueado, sem fluxo e sem pressão transmitida; depois dele
+                    // a pressão é a dos terminais (0 * inf daria NaN)
+                    double pDistal = std::isinf(h.resistencia[s]) ? prm.pressaoTerminal
+                                                                  : h.pressaoProximal[s] - q * h.resistencia[s];
+                    h.pressaoDistal[s] = (float)pDistal;
+                    // Filhos de resistência equivalente 0 (comprimento zero até os terminais)
+                    // levam todo o fluxo, em partes iguais; q/Req/g daria inf/inf
+                    double g = 0.0;
+                    int nSemResistencia = 0;
+                    for (int c = 0; c < topo.nFilhos(s); c++) {
+                        float r = h.resistenciaEq[topo.filhosDe(s)[c]];
+                        if (r == 0.0f) nSemResistencia++;
+                        else g += 1.0 / r;
+                    }
+                    for (int c = 0; c < topo.nFilhos(s); c++) {
+                        int f = topo.filhosDe(s)[c];
+                        float r = h.resistenciaEq[f];
+                        if (nSemResistencia > 0) h.fluxo[f] = r == 0.0f ? (float)(q / nSemResistencia) : 0.0f;
+                        else h.fluxo[f] = g > 0.0 ? (float)(q / r / g) : 0.0f;
+                        h.pressaoProximal[f] = (float)pDistal;
+                    }
+                }
+            });
+        }
+    }
+    return h;
+}
+
+void colorirPorCampo(Arvore2D& arvore, const std::vector<float>& campo, bool logaritmica) {
+    size_t n = std::min(arvore.segmentos.size(), campo.size());
+    // Na escala log vale |v| > 0; zeros e valores inválidos vão para as pontas
+    auto escala = [&](float v) {
+        if (!logaritmica) return v;
+        v = std::abs(v);
+        return v > 0.0f ? std::log10(v) : -std::numeric_limits<float>::infinity();
+    };
+    float menor = std::numeric_limits<float>::infinity(), maior = -menor;
+    for (size_t i = 0; i < n; i++) {
+        float v = escala(campo[i]);
+        if (std::isfinite(v)) { menor = std::min(menor, v); maior = std::max(maior, v); }
+    }
+    if (!(menor <= maior)) return;
+    float faixa = std::max(1e-6f, maior - menor);
+
+    // azul -> ciano -> amarelo -> vermelho
+    const glm::vec3 paleta[4] = {{0.1f, 0.2f, 1.0f}, {0.0f, 0.9f, 0.9f}, {1.0f, 0.9f, 0.1f}, {1.0f, 0.1f, 0.1f}};
+    for (size_t i = 0; i < n; i++) {
+        float v = escala(campo[i]);
+        float t = std::isfinite(v) ? (v - menor) / faixa : (v > 0.0f ? 1.0f : 0.0f);
+        t = std::max(0.0f, std::min(1.0f, t)) * 3.0f;
+        int k = std::min(2, (int)t);
+        arvore.segmentos[i].cor = glm::mix(paleta[k], paleta[k + 1], t - k);
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+#include "arvore.h"
+#include "escritor_vtk.h"
+
+class PoolTarefas;
+struct Topologia;
+
+// --- HEMODINÂMICA (Poiseuille) ---
+// Resolve o escoamento numa árvore carregada a partir dos raios: resistência
+// de cada segmento (8 mu L / pi r^4), resistência equivalente de baixo para
+// cima, fluxo e pressões de cima para baixo, com a pressão da raiz e a dos
+// terminais fixas. Tempo linear; cada nível da árvore é processado em
+// paralelo quando é grande o bastante.
+
+struct ParametrosHemodinamica {
+    double viscosidade = 3.6e-3;       // Pa.s
+    double pressaoRaiz = 1.33e4;       // Pa
+    double pressaoTerminal = 8.38e3;   // Pa
+    double escalaRaio = 1e-3;          // raio do arquivo -> unidade das coordenadas (pacote: mm -> m)
+};
+
+struct Hemodinamica {
+    // Um valor por segmento, na ordem de Arvore2D::segmentos
+    std::vector<float> resistencia;       // do próprio segmento, Pa.s/m^3
+    std::vector<float> resistenciaEq;     // segmento + tudo abaixo dele
+    std::vector<float> fluxo;             // m^3/s
+    std::vector<float> pressaoProximal;   // Pa
+    std::vector<float> pressaoDistal;
+    double volumeTotal = 0.0;             // m^3
+    double fluxoTotal = 0.0;              // soma das raízes, m^3/s
+
+    // Campos extras para salvarVTK (apontam para os vetores acima)
+    std::vector<CampoCelula> campos() const;
+};
+
+Hemodinamica resolverHemodinamica(const Arvore2D& arvore, const ParametrosHemodinamica& prm = {},
+                                  int threads = 0);
+// Com a topologia já montada (montarTopologia)
+Hemodinamica resolverHemodinamica(const Arvore2D& arvore, const Topologia& topo,
+                                  const ParametrosHemodinamica& prm, PoolTarefas& pool);
+
+// Pinta os segmentos pelo valor do campo (azul = menor, vermelho = maior)
+void colorirPorCampo(Arvore2D& arvore, const std::vector<float>& campo, bool logaritmica = true);
@@ -0,0 +1,118 @@
+#include "modo_bench.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+bool lerCaminhoCamera(const std::string& nome, CaminhoCamera& caminho) {
+    if (nome == "orbit") caminho = CaminhoCamera::Orbita;
+    else if (nome == "zoom") caminho = CaminhoCamera::Zoom;
+    else if (nome == "pan") caminho = CaminhoCamera::Pan;
+    else return false;
+    return true;
+}
+
+const char* nomeCaminhoCamera(CaminhoCamera caminho) {
+    switch (caminho) {
+    case CaminhoCamera::Orbita: return "orbit";
+    case CaminhoCamera::Zoom: return "zoom";
+    case CaminhoCamera::Pan: return "pan";
+    }
+    return "?";
+}
+
+Enquadramento enquadrarArvore(const Arvore2D& arvore) {
+    Enquadramento e{glm::vec3(0.0f), 1.0f};
+    if (arvore.vertices.empty()) return e;
+    glm::vec3 minimo = arvore.vertices[0].posicao, maximo = minimo;
+    for (const auto& p : arvore.vertices) {
+        minimo = glm::min(minimo, p.posicao);
+        maximo = glm::max(maximo, p.posicao);
+    }
+    e.centro = (minimo + maximo) * 0.5f;
+    e.raio = std::max(glm::length(maximo - minimo) * 0.5f, 1e-6f);
+    return e;
+}
+
+void posicionarCamera(CaminhoCamera caminho, float t, const Enquadramento& e,
+                      glm::vec3& cameraPos, float& zoomLevel, float& anguloRotacao) {
+    const float pi = 3.14159265f;
+    const float zoomBase = 0.9f / e.raio;   // árvore inteira na tela
+    switch (caminho) {
+    case CaminhoCamera::Orbita:
+        cameraPos = e.centro;
+        zoomLevel = zoomBase;
+        anguloRotacao = 360.0f * t;
+        break;
+    case CaminhoCamera::Zoom:
+        // Aproxima até 8x no meio do caminho e volta
+        cameraPos = e.centro;
+        zoomLevel = zoomBase * std::exp(std::log(8.0f) * std::sin(pi * t));
+        anguloRotacao = 0.0f;
+        break;
+    case CaminhoCamera::Pan:
+        // Lissajous sobre a árvore com zoom de 2x
+        cameraPos = e.centro + glm::vec3(std::sin(2.0f * pi * t), std::sin(4.0f * pi * t), 0.0f) * (0.5f * e.raio);
+        zoomLevel = 2.0f * zoomBase;
+        anguloRotacao = 0.0f;
+        break;
+    }
+}
+
+void posicionarCamera3D(CaminhoCamera caminho, float t, const Enquadramento& e, CameraOrbita& camera) {
+    const float pi = 3.14159265f;
+    camera.enquadrar(e.centro, e.raio);
+    float distanciaBase = camera.distancia;
+    switch (caminho) {
+    case CaminhoCamera::Orbita:
+        camera.girar(glm::vec3(0.0f, 1.0f, 0.0f), 2.0f * pi * t);
+        break;
+    case CaminhoCamera::Zoom:
+        camera.distancia = distanciaBase / std::exp(std::log(8.0f) * std::sin(pi * t));
+        break;
+    case CaminhoCamera::Pan:
+        camera.distancia = 0.5f * distanciaBase;
+        camera.alvo = e.centro + camera.orientacao * glm::vec3(std::sin(2.0f * pi * t), std::sin(4.0f * pi * t), 0.0f) * (0.5f * e.raio);
+        break;
+    }
+}
+
+// Aspas e barras escapadas, como no rastreio (o caminho vem da linha de comando)
+static void escreverTexto(std::ostringstream& s, const std::string& texto) {
+    for (char c : texto) {
+        if (c == '"' || c == '\\') s << '\\';
+        s << c;
+    }
+}
+
+static void escreverPercentis(std::ostringstream& s, const Perfilador::Percentis& p) {
+    s << "{\"p50\": " << p.p50 << ", \"p95\": " << p.p95 << ", \"p99\": " << p.p99 << "}";
+}
+
+std::string relatorioBench(const ConfigBench& cfg, const DadosBench& dados,
+                           const Perfilador& perfilador, int passeCena) {
+    long frames = std::max(1L, perfilador.framesMedidos());
+    std::ostringstream s;
+    s << "{\n";
+    s << "  \"arquivo\": \""; escreverTexto(s, cfg.arquivo); s << "\",\n";
+    s << "  \"renderizador\": \"" << cfg.renderizador << "\",\n";
+    s << "  \"caminho\": \"" << nomeCaminhoCamera(cfg.caminho) << "\",\n";
+    s << "  \"frames\": " << frames << ",\n";
+    s << "  \"segmentos\": " << dados.segmentos << ",\n";
+    s << "  \"segundos\": " << dados.segundos << ",\n";
+    s << "  \"fps_medio\": " << frames / std::max(dados.segundos, 1e-9) << ",\n";
+    s << "  \"frame_ms\": "; escreverPercentis(s, perfilador.percentisFrame()); s << ",\n";
+    s << "  \"gpu_cena_ms\": "; escreverPercentis(s, perfilador.percentisGPU(passeCena)); s << ",\n";
+    s << "  \"desenhos_por_frame\": " << (double)dados.desenhos / frames << ",\n";
+    if (cfg.renderizador.compare(0, 6, "blocos") == 0) s << "  \"frames_blocos\": " << dados.framesBlocos << ",\n";
+    if (cfg.renderizador.find("progressivo") != std::string::npos) {
+        double porFrame = (double)dados.segmentosProgressivo / frames;
+        s << "  \"progressivo\": {\"segmentos_por_frame\": " << porFrame
+          << ", \"fracao_por_frame\": " << porFrame / std::max<size_t>(dados.segmentos, 1)
+          << ", \"lote\": " << dados.loteProgressivo << ", \"desenhados\": " << dados.desenhadosProgressivo << "},\n";
+    }
+    s << "  \"bytes_carga\": " << dados.bytesCarga << ",\n";
+    s << "  \"bytes_por_frame\": " << (double)dados.bytesFrames / frames << "\n";
+    s << "}\n";
+    return s.str();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include "arvore.h"
+#include "camera_orbita.h"
+#include "perfilador.h"
+
+// --- MODO BENCHMARK ---
+// meu_app --bench <arquivo> --path orbit|zoom|pan --frames N
+// A câmera segue um caminho fixo (sem teclado, sem vsync), então duas execuções
+// sobre a mesma árvore produzem números comparáveis.
+
+enum class CaminhoCamera { Orbita, Zoom, Pan };
+
+bool lerCaminhoCamera(const std::string& nome, CaminhoCamera& caminho);
+const char* nomeCaminhoCamera(CaminhoCamera caminho);
+
+// Centro e raio da caixa envolvente, para enquadrar qualquer árvore
+struct Enquadramento { glm::vec3 centro; float raio; };
+Enquadramento enquadrarArvore(const Arvore2D& arvore);
+
+// Posiciona cameraPos/zoomLevel/anguloRotacao no instante t ∈ [0,1] do caminho
+void posicionarCamera(CaminhoCamera caminho, float t, const Enquadramento& e,
+                      glm::vec3& cameraPos, float& zoomLevel, float& anguloRotacao);
+// O mesmo para a câmera 3D: órbita = volta completa em torno do eixo vertical da tela
+void posicionarCamera3D(CaminhoCamera caminho, float t, const Enquadramento& e, CameraOrbita& camera);
+
+struct ConfigBench {
+    std::string arquivo;
+    std::string renderizador = "linhas";   // preenchido pelo visualizador: linhas, blocos, progressivo
+    CaminhoCamera caminho = CaminhoCamera::Orbita;
+    int frames = 600;
+};
+
+struct DadosBench {
+    size_t segmentos = 0;
+    size_t bytesCarga = 0;       // enviados antes do primeiro frame
+    size_t bytesFrames = 0;      // enviados durante os frames medidos
+    size_t desenhos = 0;
+    long framesBlocos = 0;       // frames compostos do cache de blocos (o resto foi desenho exato)
+    // Refinamento progressivo: a câmera anda todo frame, então cada frame é só o primeiro lote
+    size_t segmentosProgressivo = 0;
+    int loteProgressivo = 0, desenhadosProgressivo = 0;   // no último frame
+    double segundos = 0.0;
+};
+
+// Relatório final em JSON; 'passeCena' é o passe de GPU da árvore
+std::string relatorioBench(const ConfigBench& cfg, const DadosBench& dados,
+                           const Perfilador& perfilador, int passeCena);
@@ -0,0 +1,151 @@
+#include "ordem_morton.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include "pool_tarefas.h"
+#include "rastreio.h"
+
+namespace {
+
+const int GRAO = 65536;
+
+// Intercala os bits: 16 bits -> posições pares (2D), 10 bits -> a cada 3 (3D)
+uint32_t espalhar2(uint32_t x) {
+    x &= 0xFFFF;
+    x = (x | (x << 8)) & 0x00FF00FF;
+    x = (x | (x << 4)) & 0x0F0F0F0F;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    return x;
+}
+
+uint32_t espalhar3(uint32_t x) {
+    x &= 0x3FF;
+    x = (x | (x << 16)) & 0x030000FF;
+    x = (x | (x << 8)) & 0x0300F00F;
+    x = (x | (x << 4)) & 0x030C30C3;
+    x = (x | (x << 2)) & 0x09249249;
+    return x;
+}
+
+struct Quantizador {
+    glm::vec3 minimo, escala;
+    int dimensao;
+    uint32_t codigo(const glm::vec3& p) const {
+        glm::vec3 q = (p - minimo) * escala;
+        if (dimensao == 2) return espalhar2((uint32_t)q.x) | (espalhar2((uint32_t)q.y) << 1);
+        return espalhar3((uint32_t)q.x) | (espalhar3((uint32_t)q.y) << 1) | (espalhar3((uint32_t)q.z) << 2);
+    }
+};
+
+// Radix sort LSD estável de 'valores' pela chave de 32 bits, 8 bits por passada.
+// Cada passada: histograma por bloco em paralelo, prefixo (dígito, bloco) e
+// espalhamento por bloco em paralelo, mantendo a ordem dentro do bloco.
+void ordenarRadix(std::vector<uint32_t>& chaves, std::vector<int>& valores, int bits, PoolTarefas& pool) {
+    int n = (int)chaves.size();
+    int nBlocos = std::max(1, (n + GRAO - 1) / GRAO);
+    std::vector<uint32_t> chavesTmp(n);
+    std::vector<int> valoresTmp(n);
+    std::vector<size_t> posicao((size_t)nBlocos * 256);
+    for (int deslocamento = 0; deslocamento < bits; deslocamento += 8) {
+        std::fill(posicao.begin(), posicao.end(), 0);
+        pool.paraCada(nBlocos, [&](int b) {
+            size_t* h = &posicao[(size_t)b * 256];
+            for (int i = b * GRAO, fim = std::min(n, (b + 1) * GRAO); i < fim; i++) h[(chaves[i] >> deslocamento) & 0xFF]++;
+        });
+        size_t soma = 0;
+        for (int d = 0; d < 256; d++)
+            for (int b = 0; b < nBlocos; b++) {
+                size_t c = posicao[(size_t)b * 256 + d];
+                posicao[(size_t)b * 256 + d] = soma;
+                soma += c;
+            }
+        pool.paraCada(nBlocos, [&](int b) {
+            size_t* p = &posicao[(size_t)b * 256];
+            for (int i = b * GRAO, fim = std::min(n, (b + 1) * GRAO); i < fim; i++) {
+                size_t destino = p[(chaves[i] >> deslocamento) & 0xFF]++;
+                chavesTmp[destino] = chaves[i];
+                valoresTmp[destino] = valores[i];
+            }
+        });
+        chaves.swap(chavesTmp);
+        valores.swap(valoresTmp);
+    }
+}
+
+} // namespace
+
+PermutacaoArvore reordenarMorton(Arvore2D& arvore, int dimensao, int threads) {
+    RASTREIO_ESCOPO("reordenarMorton");
+    PermutacaoArvore perm;
+    int nV = (int)arvore.vertices.size(), nS = (int)arvore.segmentos.size();
+    if (nV == 0) return perm;
+    PoolTarefas pool(threads);
+
+    // Caixa envolvente (mínimos e máximos parciais por bloco)
+    int nBlocos = (nV + GRAO - 1) / GRAO;
+    std::vector<glm::vec3> minimos(nBlocos, glm::vec3(std::numeric_limits<float>::max()));
+    std::vector<glm::vec3> maximos(nBlocos, glm::vec3(-std::numeric_limits<float>::max()));
+    pool.paraBlocos(nV, GRAO, [&](int i0, int i1) {
+        glm::vec3 mn = minimos[i0 / GRAO], mx = maximos[i0 / GRAO];
+        for (int i = i0; i < i1; i++) { mn = glm::min(mn, arvore.vertices[i].posicao); mx = glm::max(mx, arvore.vertices[i].posicao); }
+        minimos[i0 / GRAO] = mn; maximos[i0 / GRAO] = mx;
+    });
+    glm::vec3 mn = minimos[0], mx = maximos[0];
+    for (int b = 1; b < nBlocos; b++) { mn = glm::min(mn, minimos[b]); mx = glm::max(mx, maximos[b]); }
+    if (dimensao == 0) dimensao = (mn.z == 0.0f && mx.z == 0.0f) ? 2 : 3;
+
+    Quantizador q;
+    q.dimensao = dimensao;
+    q.minimo = mn;
+    float passos = dimensao == 2 ? 65535.0f : 1023.0f;
+    glm::vec3 extensao = glm::max(mx - mn, glm::vec3(1e-30f));
+    q.escala = glm::vec3(passos) / extensao;
+    int bits = dimensao == 2 ? 32 : 30;
+
+    // 1. Vértices
+    std::vector<uint32_t> chaves(nV);
+    perm.verticeOriginal.resize(nV);
+    pool.paraBlocos(nV, GRAO, [&](int i0, int i1) {
+        for (int i = i0; i < i1; i++) { chaves[i] = q.codigo(arvore.vertices[i].posicao); perm.verticeOriginal[i] = i; }
+    });
+    ordenarRadix(chaves, perm.verticeOriginal, bits, pool);
+
+    // Permuta por um temporário no heap e copia de volta no lugar: a árvore
+    // pode estar numa arena monotônica, onde um array novo não substitui o antigo
+    std::vector<int> novoVertice(nV);
+    std::vector<Ponto> vertices(nV);
+    pool.paraBlocos(nV, GRAO, [&](int i0, int i1) {
+        for (int i = i0; i < i1; i++) {
+            novoVertice[perm.verticeOriginal[i]] = i;
+            vertices[i] = arvore.vertices[perm.verticeOriginal[i]];
+        }
+    });
+    pool.paraBlocos(nV, GRAO, [&](int i0, int i1) { std::copy(vertices.begin() + i0, vertices.begin() + i1, arvore.vertices.begin() + i0); });
+    std::vector<Ponto>().swap(vertices);
+
+    // 2. Segmentos, pelo ponto médio (índices inválidos ficam como estão)
+    auto remapear = [&](int v) { return v >= 0 && v < nV ? novoVertice[v] : v; };
+    chaves.resize(nS);
+    perm.segmentoOriginal.resize(nS);
+    pool.paraBlocos(nS, GRAO, [&](int i0, int i1) {
+        for (int i = i0; i < i1; i++) {
+            Segmento& s = arvore.segmentos[i];
+            s.indicePontoA = remapear(s.indicePontoA);
+            s.indicePontoB = remapear(s.indicePontoB);
+            bool valido = s.indicePontoA >= 0 && s.indicePontoA < nV && s.indicePontoB >= 0 && s.indicePontoB < nV;
+            chaves[i] = valido ? q.codigo(0.5f * (arvore.vertices[s.indicePontoA].posicao + arvore.vertices[s.indicePontoB].posicao)) : 0xFFFFFFFFu;
+            perm.segmentoOriginal[i] = i;
+        }
+    });
+    ordenarRadix(chaves, perm.segmentoOriginal, 32, pool);
+
+    std::vector<Segmento> segmentos(nS);
+    pool.paraBlocos(nS, GRAO, [&](int i0, int i1) {
+        for (int i = i0; i < i1; i++) segmentos[i] = arvore.segmentos[perm.segmentoOriginal[i]];
+    });
+    pool.paraBlocos(nS, GRAO, [&](int i0, int i1) { std::copy(segmentos.begin() + i0, segmentos.begin() + i1, arvore.segmentos.begin() + i0); });
+    return perm;
+}
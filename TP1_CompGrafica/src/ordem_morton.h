@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+
+#include "arvore.h"
+
+// --- REORDENAÇÃO EM ORDEM DE MORTON (curva Z) ---
+// Os arquivos trazem os pontos na ordem de inserção do CCO, espalhados pelo
+// domínio. Esta passada opcional ordena os vértices pelo código de Morton da
+// posição e os segmentos pelo código do ponto médio (radix sort paralelo),
+// e refaz indicePontoA/B. Vizinhos no espaço ficam vizinhos na memória, o que
+// ajuda culling, picking e a leitura de vértices na GPU.
+//
+// Os segmentos deixam de estar na ordem de crescimento (K/J no visualizador).
+
+struct PermutacaoArvore {
+    std::vector<int> verticeOriginal;    // índice novo -> índice no arquivo
+    std::vector<int> segmentoOriginal;
+    bool vazia() const { return segmentoOriginal.empty(); }
+};
+
+// dimensao = 0 detecta pelo z (tudo em z = 0 é 2D); threads = 0 usa todos os núcleos
+PermutacaoArvore reordenarMorton(Arvore2D& arvore, int dimensao = 0, int threads = 0);
@@ -0,0 +1,312 @@
+#include "perfilador.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// --- SHADERS DO HUD (posição já em NDC + cor) ---
+static const char* hudVertexSource = "#version 330 core\n"
+    "layout (location = 0) in vec2 aPos;\n"
+    "layout (location = 1) in vec3 aColor;\n"
+    "out vec3 ourColor;\n"
+    "void main(){ gl_Position = vec4(aPos, 0.0, 1.0); ourColor = aColor; }\0";
+
+static const char* hudFragmentSource = "#version 330 core\n"
+    "out vec4 FragColor;\n"
+    "in vec3 ourColor;\n"
+    "void main(){ FragColor = vec4(ourColor, 1.0f); }\n\0";
+
+// Cores das barras, na ordem em que as etapas foram registradas
+static const float paleta[][3] = {
+    {0.90f, 0.35f, 0.35f}, {0.35f, 0.80f, 0.40f}, {0.35f, 0.55f, 0.95f},
+    {0.95f, 0.80f, 0.30f}, {0.75f, 0.45f, 0.90f}, {0.30f, 0.85f, 0.85f},
+};
+static const int tamanhoPaleta = sizeof(paleta) / sizeof(paleta[0]);
+
+static const double ESCALA_MS = 33.3;   // largura total das barras = dois frames a 60 Hz
+
+// --- JANELA MÓVEL ---
+void Perfilador::Janela::adicionar(double v, bool historico) {
+    if (historico || (int)amostras.size() < JANELA) { amostras.push_back(v); return; }
+    amostras[proxima] = v;
+    proxima = (proxima + 1) % JANELA;
+}
+
+Perfilador::Percentis Perfilador::Janela::calcular() const {
+    Percentis p;
+    if (amostras.empty()) return p;
+    std::vector<double> ordenadas(amostras);
+    std::sort(ordenadas.begin(), ordenadas.end());
+    auto em = [&](double q) { return ordenadas[std::min(ordenadas.size() - 1, (size_t)(q * ordenadas.size()))]; };
+    p.p50 = em(0.50); p.p95 = em(0.95); p.p99 = em(0.99);
+    return p;
+}
+
+// --- REGISTRO ---
+int Perfilador::etapaCPU(const std::string& nome) {
+    Etapa e; e.nome = nome;
+    etapas.push_back(e);
+    return (int)etapas.size() - 1;
+}
+
+int Perfilador::passeGPU(const std::string& nome) {
+    Passe p; p.nome = nome;
+    for (int i = 0; i < LATENCIA_GPU; i++) p.frameDaConsulta[i] = -1;
+    passes.push_back(p);
+    return (int)passes.size() - 1;
+}
+
+void Perfilador::registrarProgramas(GerenciadorProgramas& programas) {
+    gerenciador = &programas;
+    idPrograma = programas.adicionar("hud", hudVertexSource, hudFragmentSource);
+}
+
+void Perfilador::iniciarGPU() {
+    for (auto& p : passes) glGenQueries(LATENCIA_GPU, p.consultas);
+
+    if (gerenciador) {
+        hudPrograma = gerenciador->programa(idPrograma);   // o gerenciador é o dono
+    } else {
+        unsigned int v = glCreateShader(GL_VERTEX_SHADER); glShaderSource(v, 1, &hudVertexSource, NULL); glCompileShader(v);
+        unsigned int f = glCreateShader(GL_FRAGMENT_SHADER); glShaderSource(f, 1, &hudFragmentSource, NULL); glCompileShader(f);
+        hudPrograma = glCreateProgram(); glAttachShader(hudPrograma, v); glAttachShader(hudPrograma, f); glLinkProgram(hudPrograma);
+        glDeleteShader(v); glDeleteShader(f);
+    }
+
+    glGenVertexArrays(1, &hudVAO); glGenBuffers(1, &hudVBO);
+    glBindVertexArray(hudVAO); glBindBuffer(GL_ARRAY_BUFFER, hudVBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 5*sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 5*sizeof(float), (void*)(2*sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+
+    inicio = ultimoCalculo = std::chrono::steady_clock::now();
+    gpuPronta = true;
+}
+
+void Perfilador::liberarGPU() {
+    if (!gpuPronta) return;
+    fecharCSV();
+    for (auto& p : passes) glDeleteQueries(LATENCIA_GPU, p.consultas);
+    glDeleteVertexArrays(1, &hudVAO); glDeleteBuffers(1, &hudVBO);
+    if (!gerenciador) glDeleteProgram(hudPrograma);
+    gpuPronta = false;
+}
+
+// --- CSV ---
+bool Perfilador::abrirCSV(const std::string& caminho) {
+    csv.open(caminho);
+    if (!csv.is_open()) {
+        std::cerr << "ERRO: Nao consegui criar " << caminho << std::endl;
+        return false;
+    }
+    csv << "frame,tempo_s,frame_ms";
+    for (const auto& e : etapas) csv << ",cpu_" << e.nome << "_ms";
+    for (const auto& p : passes) csv << ",gpu_" << p.nome << "_ms";
+    csv << "\n";
+    return true;
+}
+
+void Perfilador::fecharCSV() {
+    if (!csv.is_open()) return;
+    // As linhas pendentes saem com o que a GPU já entregou
+    colherGPU();
+    long menor = frameAtual - LATENCIA_GPU + 1;
+    for (long f = std::max(0L, menor); f <= frameAtual; f++) escreverLinha(linhas[f % LATENCIA_GPU]);
+    csv.close();
+}
+
+void Perfilador::escreverLinha(LinhaCSV& linha) {
+    if (linha.frame < 0) return;
+    csv << linha.frame << "," << linha.tempo << "," << linha.frameMs;
+    for (double v : linha.valores) {
+        csv << ",";
+        if (v >= 0.0) csv << v;   // vazio = sem medição neste frame
+    }
+    csv << "\n";
+    linha.frame = -1;
+}
+
+// --- FRAME ---
+void Perfilador::colherGPU() {
+    for (size_t i = 0; i < passes.size(); i++) {
+        Passe& p = passes[i];
+        for (int s = 0; s < LATENCIA_GPU; s++) {
+            if (p.frameDaConsulta[s] < 0) continue;
+            GLint pronto = 0;
+            glGetQueryObjectiv(p.consultas[s], GL_QUERY_RESULT_AVAILABLE, &pronto);
+            if (!pronto) continue;
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(p.consultas[s], GL_QUERY_RESULT, &ns);
+            double ms = ns / 1.0e6;
+            p.janela.adicionar(ms, historico);
+
+            LinhaCSV& linha = linhas[p.frameDaConsulta[s] % LATENCIA_GPU];
+            if (linha.frame == p.frameDaConsulta[s]) linha.valores[etapas.size() + i] = ms;
+            p.frameDaConsulta[s] = -1;
+        }
+    }
+}
+
+void Perfilador::inicioFrame() {
+    frameAtual++;
+    inicioDoFrame = std::chrono::steady_clock::now();
+    if (gpuPronta) colherGPU();
+
+    // A linha que ocupava este lugar (frame - LATENCIA_GPU) não recebe mais resultados
+    LinhaCSV& linha = linhas[frameAtual % LATENCIA_GPU];
+    if (csv.is_open()) escreverLinha(linha);
+    linha.frame = frameAtual;
+    linha.tempo = std::chrono::duration<double>(inicioDoFrame - inicio).count();
+    linha.valores.assign(etapas.size() + passes.size(), -1.0);
+}
+
+void Perfilador::fimFrame() {
+    auto agora = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(agora - inicioDoFrame).count();
+    janelaFrame.adicionar(ms, historico);
+    linhas[frameAtual % LATENCIA_GPU].frameMs = ms;
+
+    // Percentis não precisam ser recalculados a cada frame
+    if (!historico && std::chrono::duration<double>(agora - ultimoCalculo).count() > 0.25) {
+        recalcularPercentis();
+        ultimoCalculo = agora;
+    }
+}
+
+void Perfilador::recalcularPercentis() {
+    pctFrame = janelaFrame.calcular();
+    for (auto& e : etapas) e.pct = e.janela.calcular();
+    for (auto& p : passes) p.pct = p.janela.calcular();
+}
+
+void Perfilador::finalizarGPU() {
+    if (gpuPronta) {
+        glFinish();
+        colherGPU();
+    }
+    recalcularPercentis();
+}
+
+void Perfilador::registrarCPU(int etapa, double ms) {
+    Etapa& e = etapas[etapa];
+    e.janela.adicionar(ms, historico);
+    e.ultimoMs = ms;
+    if (frameAtual >= 0) linhas[frameAtual % LATENCIA_GPU].valores[etapa] = ms;
+}
+
+void Perfilador::inicioGPU(int passe) {
+    Passe& p = passes[passe];
+    p.ativo = false;
+    if (!gpuPronta) return;
+    int s = frameAtual % LATENCIA_GPU;
+    // Consulta antiga ainda na GPU: pula a medição em vez de esperar
+    if (p.frameDaConsulta[s] >= 0) return;
+    glBeginQuery(GL_TIME_ELAPSED, p.consultas[s]);
+    p.frameDaConsulta[s] = frameAtual;
+    p.ativo = true;
+}
+
+void Perfilador::fimGPU(int passe) {
+    if (!passes[passe].ativo) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    passes[passe].ativo = false;
+}
+
+std::string Perfilador::resumo() const {
+    char buf[64];
+    std::string s;
+    snprintf(buf, sizeof(buf), "frame p50 %.2f p99 %.2f ms", pctFrame.p50, pctFrame.p99);
+    s += buf;
+    for (const auto& p : passes) {
+        snprintf(buf, sizeof(buf), " | gpu %s %.2f ms", p.nome.c_str(), p.pct.p50);
+        s += buf;
+    }
+    return s;
+}
+
+// --- HUD ---
+void Perfilador::desenharHUD(int largura, int altura) {
+    if (!gpuPronta || largura <= 0 || altura <= 0) return;
+
+    // Tudo é montado em pixels (origem no canto superior esquerdo) e convertido para NDC
+    auto ponto = [&](float px, float py, const float* cor) {
+        hudVertices.push_back(px / largura * 2.0f - 1.0f);
+        hudVertices.push_back(1.0f - py / altura * 2.0f);
+        hudVertices.push_back(cor[0]); hudVertices.push_back(cor[1]); hudVertices.push_back(cor[2]);
+    };
+    auto retangulo = [&](float x0, float y0, float x1, float y1, const float* cor) {
+        ponto(x0, y0, cor); ponto(x1, y0, cor); ponto(x1, y1, cor);
+        ponto(x0, y0, cor); ponto(x1, y1, cor); ponto(x0, y1, cor);
+    };
+
+    const float margem = 10.0f, larguraBarra = 300.0f, alturaLinha = 10.0f, espaco = 4.0f, alturaGrafico = 60.0f;
+    const float pxPorMs = larguraBarra / (float)ESCALA_MS;
+    const float fundo[3] = {0.0f, 0.0f, 0.0f};
+    const float branco[3] = {1.0f, 1.0f, 1.0f};
+    const float cinza[3] = {0.5f, 0.5f, 0.5f};
+    int linhasHUD = 1 + (int)etapas.size() + (int)passes.size();
+    float alturaPainel = linhasHUD * (alturaLinha + espaco) + espaco + alturaGrafico + espaco;
+
+    hudVertices.clear();
+    retangulo(margem, margem, margem + larguraBarra + 2 * espaco, margem + alturaPainel, fundo);
+
+    // Barras: p50 preenchido, p95 e p99 como marcas (linhas) logo depois
+    std::vector<float> marcas;
+    float y = margem + espaco;
+    auto barra = [&](const Percentis& p, const float* cor) {
+        float x0 = margem + espaco;
+        retangulo(x0, y, x0 + std::min(larguraBarra, (float)p.p50 * pxPorMs), y + alturaLinha, cor);
+        for (double q : {p.p95, p.p99}) {
+            float x = x0 + std::min(larguraBarra, (float)q * pxPorMs);
+            marcas.push_back(x); marcas.push_back(y);
+        }
+        y += alturaLinha + espaco;
+    };
+    barra(pctFrame, branco);
+    for (size_t i = 0; i < etapas.size(); i++) barra(etapas[i].pct, paleta[i % tamanhoPaleta]);
+    for (size_t i = 0; i < passes.size(); i++) {
+        const float* c = paleta[(etapas.size() + i) % tamanhoPaleta];
+        const float clara[3] = {0.5f + 0.5f * c[0], 0.5f + 0.5f * c[1], 0.5f + 0.5f * c[2]};
+        barra(passes[i].pct, clara);
+    }
+    size_t nTriangulos = hudVertices.size() / 5;
+
+    for (size_t i = 0; i < marcas.size(); i += 2) {
+        ponto(marcas[i], marcas[i + 1] - 2.0f, branco);
+        ponto(marcas[i], marcas[i + 1] + alturaLinha + 2.0f, branco);
+    }
+
+    // Gráfico dos últimos frames, com referência em 16,7 ms
+    float base = y + alturaGrafico;
+    float ref = base - std::min(alturaGrafico, 16.7f * alturaGrafico / (float)ESCALA_MS);
+    ponto(margem + espaco, ref, cinza); ponto(margem + espaco + larguraBarra, ref, cinza);
+    const auto& a = janelaFrame.amostras;
+    int n = std::min((int)a.size(), JANELA);
+    // Percorre do mais antigo ao mais novo; com histórico, só os últimos JANELA
+    auto indice = [&](int k) { return historico ? (int)a.size() - n + k : (janelaFrame.proxima + k) % n; };
+    float passo = larguraBarra / JANELA;
+    for (int i = 1; i < n; i++) {
+        int i0 = indice(i - 1), i1 = indice(i);
+        float y0 = base - std::min(alturaGrafico, (float)a[i0] * alturaGrafico / (float)ESCALA_MS);
+        float y1 = base - std::min(alturaGrafico, (float)a[i1] * alturaGrafico / (float)ESCALA_MS);
+        ponto(margem + espaco + (i - 1) * passo, y0, branco);
+        ponto(margem + espaco + i * passo, y1, branco);
+    }
+    size_t nLinhas = hudVertices.size() / 5 - nTriangulos;
+
+    // O HUD fica por cima da cena: em 3D o teste de profundidade o esconderia
+    GLboolean comProfundidade = glIsEnabled(GL_DEPTH_TEST);
+    if (comProfundidade) glDisable(GL_DEPTH_TEST);
+
+    glUseProgram(hudPrograma);
+    glBindVertexArray(hudVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, hudVBO);
+    glBufferData(GL_ARRAY_BUFFER, hudVertices.size() * sizeof(float), hudVertices.data(), GL_STREAM_DRAW);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)nTriangulos);
+    glDrawArrays(GL_LINES, (GLint)nTriangulos, (GLsizei)nLinhas);
+    if (comProfundidade) glEnable(GL_DEPTH_TEST);
+    contarDesenho(2);
+    contarEnvio(hudVertices.size() * sizeof(float));
+}
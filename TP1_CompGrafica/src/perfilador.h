@@ -0,0 +1,127 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "programas_gl.h"
+
+// --- PERFILADOR ---
+// Mede onde o tempo do frame vai: temporizadores de escopo no lado da CPU e
+// consultas GL_TIME_ELAPSED no lado da GPU. As consultas de cada passe ficam num
+// anel de LATENCIA_GPU frames e só são lidas quando o resultado já está disponível,
+// então medir nunca trava o pipeline.
+class Perfilador {
+public:
+    static const int JANELA = 240;      // amostras guardadas por etapa (percentis móveis)
+    static const int LATENCIA_GPU = 4;  // profundidade do anel de consultas
+
+    struct Percentis { double p50 = 0.0, p95 = 0.0, p99 = 0.0; };
+
+    // Registra uma etapa de CPU / passe de GPU e devolve o índice usado nas medições.
+    // Devem ser chamados antes do primeiro frame.
+    int etapaCPU(const std::string& nome);
+    int passeGPU(const std::string& nome);
+
+    // Coloca o programa do HUD no lote do gerenciador (antes de compilarTodos);
+    // sem isso iniciarGPU compila o seu
+    void registrarProgramas(GerenciadorProgramas& programas);
+    void iniciarGPU();   // precisa do contexto GL ativo
+    void liberarGPU();
+    bool abrirCSV(const std::string& caminho);
+    void fecharCSV();
+
+    void inicioFrame();
+    void fimFrame();
+    void registrarCPU(int etapa, double ms);
+    void inicioGPU(int passe);
+    void fimGPU(int passe);
+    void finalizarGPU();   // espera a GPU e colhe as consultas pendentes (fim de benchmark)
+
+    // Guarda todas as amostras em vez da janela móvel (modo benchmark)
+    void manterHistorico(bool sim) { historico = sim; }
+
+    // Contadores de chamadas de desenho e bytes enviados à GPU
+    void contarDesenho(int chamadas = 1) { desenhosTotal += chamadas; }
+    void contarEnvio(size_t bytes) { bytesEnviadosTotal += bytes; }
+    size_t totalDesenhos() const { return desenhosTotal; }
+    size_t totalBytesEnviados() const { return bytesEnviadosTotal; }
+    long framesMedidos() const { return frameAtual + 1; }
+
+    Percentis percentisFrame() const { return pctFrame; }
+    Percentis percentisCPU(int etapa) const { return etapas[etapa].pct; }
+    Percentis percentisGPU(int passe) const { return passes[passe].pct; }
+    std::string resumo() const;   // texto curto para o título da janela
+
+    // Barras p50/p95/p99 por etapa e gráfico dos últimos frames, no canto da tela
+    void desenharHUD(int largura, int altura);
+
+private:
+    struct Janela {
+        std::vector<double> amostras;
+        int proxima = 0;
+        void adicionar(double v, bool historico);
+        Percentis calcular() const;
+    };
+    struct Etapa {
+        std::string nome;
+        Janela janela;
+        Percentis pct;
+        double ultimoMs = -1.0;
+    };
+    struct Passe {
+        std::string nome;
+        Janela janela;
+        Percentis pct;
+        GLuint consultas[LATENCIA_GPU] = {};
+        long frameDaConsulta[LATENCIA_GPU];  // -1 = livre
+        bool ativo = false;
+    };
+    // Linha do CSV aguardando os resultados (atrasados) da GPU
+    struct LinhaCSV {
+        long frame = -1;
+        double tempo = 0.0;
+        double frameMs = 0.0;
+        std::vector<double> valores;   // etapas de CPU seguidas dos passes de GPU
+    };
+
+    void colherGPU();
+    void escreverLinha(LinhaCSV& linha);
+    void recalcularPercentis();
+
+    std::vector<Etapa> etapas;
+    std::vector<Passe> passes;
+    Janela janelaFrame;
+    Percentis pctFrame;
+    long frameAtual = -1;
+    bool gpuPronta = false;
+    bool historico = false;
+    size_t desenhosTotal = 0, bytesEnviadosTotal = 0;
+    std::chrono::steady_clock::time_point inicio, inicioDoFrame, ultimoCalculo;
+
+    std::ofstream csv;
+    LinhaCSV linhas[LATENCIA_GPU];
+
+    GLuint hudPrograma = 0, hudVAO = 0, hudVBO = 0;
+    GerenciadorProgramas* gerenciador = nullptr;
+    int idPrograma = -1;
+    std::vector<float> hudVertices;
+};
+
+// Mede o tempo de CPU do escopo em que foi declarado
+class TemporizadorCPU {
+public:
+    TemporizadorCPU(Perfilador& p, int etapa)
+        : perfilador(p), etapa(etapa), inicio(std::chrono::steady_clock::now()) {}
+    ~TemporizadorCPU() {
+        std::chrono::duration<double, std::milli> d = std::chrono::steady_clock::now() - inicio;
+        perfilador.registrarCPU(etapa, d.count());
+    }
+private:
+    Perfilador& perfilador;
+    int etapa;
+    std::chrono::steady_clock::time_point inicio;
+};
@@ -0,0 +1,94 @@
+#include "png_simples.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+
+const size_t MAX_BLOCO = 65535;   // limite de um bloco stored
+
+const uint32_t* tabelaCrc() {
+    static const auto tabela = [] {
+        std::array<uint32_t, 256> t;
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[n] = c;
+        }
+        return t;
+    }();
+    return tabela.data();
+}
+
+uint32_t crc(const uint8_t* p, size_t n) {
+    const uint32_t* t = tabelaCrc();
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < n; i++) c = t[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+void be32(uint8_t* p, uint32_t v) { p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v; }
+
+size_t bytesCrus(int largura, int altura) { return (size_t)altura * (1 + 3 * (size_t)largura); }
+
+size_t bytesZlib(size_t crus) {
+    size_t blocos = std::max<size_t>(1, (crus + MAX_BLOCO - 1) / MAX_BLOCO);
+    return 2 + crus + 5 * blocos + 4;
+}
+
+} // namespace
+
+size_t tamanhoPNG(int largura, int altura) {
+    return 8 + (12 + 13) + (12 + bytesZlib(bytesCrus(largura, altura))) + 12;
+}
+
+void codificarPNG(const uint8_t* rgba, int largura, int altura, uint8_t* saida) {
+    static const uint8_t assinatura[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    uint8_t* p = saida;
+    std::memcpy(p, assinatura, 8); p += 8;
+
+    // IHDR
+    be32(p, 13); std::memcpy(p + 4, "IHDR", 4);
+    be32(p + 8, largura); be32(p + 12, altura);
+    p[16] = 8; p[17] = 2; p[18] = 0; p[19] = 0; p[20] = 0;   // 8 bits, RGB, deflate, filtro 0, sem entrelaçamento
+    be32(p + 21, crc(p + 4, 17));
+    p += 25;
+
+    // IDAT: zlib (CMF/FLG), blocos stored e adler-32; as linhas (filtro 0 + RGB)
+    // são geradas direto dentro dos blocos
+    size_t crus = bytesCrus(largura, altura), zlib = bytesZlib(crus);
+    uint8_t* idat = p;
+    be32(p, (uint32_t)zlib); std::memcpy(p + 4, "IDAT", 4);
+    p += 8;
+    *p++ = 0x78; *p++ = 0x01;
+    uint32_t a = 1, b = 0;
+    size_t restante = crus, noBloco = 0;
+    auto emitir = [&](uint8_t v) {
+        if (noBloco == 0) {   // cabeçalho do próximo bloco: BFINAL, BTYPE = 00, LEN, NLEN
+            noBloco = std::min(restante, MAX_BLOCO);
+            restante -= noBloco;
+            *p++ = restante == 0 ? 1 : 0;
+            p[0] = noBloco & 0xFF; p[1] = (noBloco >> 8) & 0xFF; p[2] = ~noBloco & 0xFF; p[3] = (~noBloco >> 8) & 0xFF;
+            p += 4;
+        }
+        *p++ = v;
+        noBloco--;
+        a += v; if (a >= 65521) a -= 65521;
+        b += a; if (b >= 65521) b -= 65521;
+    };
+    if (crus == 0) {   // imagem vazia: um bloco final sem dados
+        *p++ = 1; p[0] = 0; p[1] = 0; p[2] = 0xFF; p[3] = 0xFF; p += 4;
+    }
+    for (int y = 0; y < altura; y++) {
+        emitir(0);   // filtro 0
+        const uint8_t* px = rgba + (size_t)y * largura * 4;
+        for (int x = 0; x < largura; x++, px += 4) { emitir(px[0]); emitir(px[1]); emitir(px[2]); }
+    }
+    be32(p, (b << 16) | a); p += 4;
+    be32(p, crc(idat + 4, p - idat - 4)); p += 4;
+
+    // IEND
+    be32(p, 0); std::memcpy(p + 4, "IEND", 4);
+    be32(p + 8, crc(p + 4, 4));
+}
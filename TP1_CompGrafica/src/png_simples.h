@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// --- PNG MÍNIMO ---
+// RGB 8 bits, um IDAT com deflate "stored" (blocos sem compressão): nada de
+// zlib, e o tamanho final é conhecido antes de codificar, então a saída pode
+// ir direto para um buffer já mapeado (ex.: memória compartilhada).
+// Arquivos ficam do tamanho da imagem crua (+ ~0,01%).
+
+size_t tamanhoPNG(int largura, int altura);
+// 'rgba' tem largura * altura * 4 bytes, linha 0 no topo; o alfa é descartado.
+// 'saida' precisa de tamanhoPNG() bytes.
+void codificarPNG(const uint8_t* rgba, int largura, int altura, uint8_t* saida);
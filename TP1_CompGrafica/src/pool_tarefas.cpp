@@ -0,0 +1,89 @@
+#include "pool_tarefas.h"
+
+#include <algorithm>
+
+PoolTarefas::PoolTarefas(int threads) {
+    if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 0; i < threads; i++) filas.emplace_back(new Fila());
+    for (int i = 1; i < threads; i++) trabalhadores.emplace_back(&PoolTarefas::laco, this, i);
+}
+
+PoolTarefas::~PoolTarefas() {
+    {
+        std::lock_guard<std::mutex> l(mDorme);
+        parar = true;
+    }
+    cvDorme.notify_all();
+    for (auto& t : trabalhadores) t.join();
+}
+
+bool PoolTarefas::pegar(int eu, Faixa& f) {
+    // Da própria fila pelo fim (mais recente, ainda quente no cache)...
+    {
+        Fila& minha = *filas[eu];
+        std::lock_guard<std::mutex> l(minha.m);
+        if (!minha.d.empty()) { f = minha.d.back(); minha.d.pop_back(); return true; }
+    }
+    // ...e das outras pelo começo
+    for (size_t k = 1; k < filas.size(); k++) {
+        Fila& outra = *filas[(eu + k) % filas.size()];
+        std::lock_guard<std::mutex> l(outra.m);
+        if (!outra.d.empty()) { f = outra.d.front(); outra.d.pop_front(); return true; }
+    }
+    return false;
+}
+
+void PoolTarefas::executar(const Faixa& f) {
+    for (int i = f.inicio; i < f.fim; i++) (*trabalho)(i);
+    pendentes.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void PoolTarefas::laco(int eu) {
+    uint64_t vista = 0;
+    while (true) {
+        Faixa f;
+        if (pegar(eu, f)) { executar(f); continue; }
+        // Gira um pouco: o próximo paraCada costuma vir logo em seguida
+        bool achou = false;
+        for (int giro = 0; giro < 256 && !achou; giro++) {
+            if (pendentes.load(std::memory_order_acquire) > 0 && pegar(eu, f)) { executar(f); achou = true; }
+            else std::this_thread::yield();
+        }
+        if (achou) continue;
+        std::unique_lock<std::mutex> l(mDorme);
+        cvDorme.wait(l, [&]() { return parar || geracao != vista; });
+        if (parar) return;
+        vista = geracao;
+    }
+}
+
+void PoolTarefas::paraCada(int n, const std::function<void(int)>& f, int grao) {
+    if (n <= 0) return;
+    grao = std::max(1, grao);
+    if (filas.size() == 1 || n <= grao) {
+        for (int i = 0; i < n; i++) f(i);
+        return;
+    }
+
+    trabalho = &f;
+    int nFaixas = (n + grao - 1) / grao;
+    pendentes.store(nFaixas, std::memory_order_release);
+    for (int k = 0; k < nFaixas; k++) {
+        Fila& fila = *filas[k % filas.size()];
+        std::lock_guard<std::mutex> l(fila.m);
+        fila.d.push_back({k * grao, std::min(n, (k + 1) * grao)});
+    }
+    {
+        std::lock_guard<std::mutex> l(mDorme);
+        geracao++;
+    }
+    cvDorme.notify_all();
+
+    // Quem chamou ajuda até a última faixa terminar
+    Faixa fx;
+    while (pendentes.load(std::memory_order_acquire) > 0) {
+        if (pegar(0, fx)) executar(fx);
+        else std::this_thread::yield();
+    }
+    trabalho = nullptr;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// --- POOL DE TAREFAS COM ROUBO DE TRABALHO ---
+// Cada thread tem a própria fila de faixas de índices: consome do fim da sua
+// e, quando acaba, rouba do começo das outras. A thread que chama paraCada()
+// também trabalha (é a fila 0), então com 1 thread tudo roda em série.
+//
+// Feito para laços curtos e repetidos (ex.: avaliar ~20 candidatos por
+// terminal no CCO): as threads giram um pouco antes de dormir, para não pagar
+// o custo de acordar a cada chamada.
+class PoolTarefas {
+public:
+    explicit PoolTarefas(int threads = 0);   // 0 = número de núcleos
+    ~PoolTarefas();
+    PoolTarefas(const PoolTarefas&) = delete;
+    PoolTarefas& operator=(const PoolTarefas&) = delete;
+
+    int threads() const { return (int)filas.size(); }
+
+    // Executa f(i) para todo i em [0, n), em faixas de 'grao' índices, e espera terminar.
+    // Não é reentrante: f não pode chamar paraCada no mesmo pool.
+    void paraCada(int n, const std::function<void(int)>& f, int grao = 1);
+
+    // f(inicio, fim) sobre [0, n) em blocos de 'grao' índices; um bloco só roda direto
+    template <typename F>
+    void paraBlocos(int n, int grao, F f) {
+        int nBlocos = (n + grao - 1) / grao;
+        if (nBlocos <= 1) { if (n > 0) f(0, n); return; }
+        paraCada(nBlocos, [&](int b) { f(b * grao, std::min(n, (b + 1) * grao)); });
+    }
+
+private:
+    struct Faixa { int inicio, fim; };
+    struct Fila {
+        std::mutex m;
+        std::deque<Faixa> d;
+    };
+
+    bool pegar(int eu, Faixa& f);
+    void executar(const Faixa& f);
+    void laco(int eu);
+
+    std::vector<std::unique_ptr<Fila>> filas;
+    std::vector<std::thread> trabalhadores;
+    const std::function<void(int)>* trabalho = nullptr;
+    std::atomic<int> pendentes{0};   // faixas ainda não terminadas
+    std::mutex mDorme;
+    std::condition_variable cvDorme;
+    uint64_t geracao = 0;            // muda a cada paraCada (protegido por mDorme)
+    bool parar = false;
+};
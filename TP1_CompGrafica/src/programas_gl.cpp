@@ -0,0 +1,231 @@
+#include "programas_gl.h"
+
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include "rastreio.h"
+
+// Constantes e assinaturas que o glad 3.3 não traz
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+namespace {
+
+typedef void (APIENTRYP FnGetProgramBinary)(GLuint, GLsizei, GLsizei*, GLenum*, void*);
+typedef void (APIENTRYP FnProgramBinary)(GLuint, GLenum, const void*, GLsizei);
+typedef void (APIENTRYP FnProgramParameteri)(GLuint, GLenum, GLint);
+typedef void (APIENTRYP FnMaxShaderCompilerThreads)(GLuint);
+
+FnGetProgramBinary pGetProgramBinary = nullptr;
+FnProgramBinary pProgramBinary = nullptr;
+FnProgramParameteri pProgramParameteri = nullptr;
+
+const char MAGICA[4] = {'P', 'G', 'M', 'B'};
+
+// FNV-1a 64 bits
+uint64_t misturar(uint64_t h, const char* s) {
+    if (!s) s = "";
+    for (; *s; s++) { h ^= (unsigned char)*s; h *= 1099511628211ull; }
+    return h ^ 0xFF;   // separador: "ab"+"c" != "a"+"bc"
+}
+
+const char* textoGL(GLenum nome) {
+    const GLubyte* s = glGetString(nome);
+    return s ? (const char*)s : "";
+}
+
+void imprimirLog(const std::string& programa, const char* etapa, GLuint objeto, bool ehPrograma) {
+    GLint tamanho = 0;
+    if (ehPrograma) glGetProgramiv(objeto, GL_INFO_LOG_LENGTH, &tamanho);
+    else glGetShaderiv(objeto, GL_INFO_LOG_LENGTH, &tamanho);
+    std::string log(tamanho > 0 ? tamanho : 1, '\0');
+    if (ehPrograma) glGetProgramInfoLog(objeto, (GLsizei)log.size(), NULL, &log[0]);
+    else glGetShaderInfoLog(objeto, (GLsizei)log.size(), NULL, &log[0]);
+    std::cerr << "ERRO: " << etapa << " do programa '" << programa << "' falhou:\n" << log.c_str() << std::endl;
+}
+
+} // namespace
+
+void GerenciadorProgramas::iniciar(const std::string& diretorioCache) {
+    pGetProgramBinary = (FnGetProgramBinary)glfwGetProcAddress("glGetProgramBinary");
+    pProgramBinary = (FnProgramBinary)glfwGetProcAddress("glProgramBinary");
+    pProgramParameteri = (FnProgramParameteri)glfwGetProcAddress("glProgramParameteri");
+    GLint formatos = 0;
+    if (pGetProgramBinary && pProgramBinary && pProgramParameteri) glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatos);
+    temBinario = formatos > 0 && !diretorioCache.empty();
+
+    FnMaxShaderCompilerThreads maxThreads = nullptr;
+    if (glfwExtensionSupported("GL_KHR_parallel_shader_compile"))
+        maxThreads = (FnMaxShaderCompilerThreads)glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+    else if (glfwExtensionSupported("GL_ARB_parallel_shader_compile"))
+        maxThreads = (FnMaxShaderCompilerThreads)glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+    temParalelo = maxThreads != nullptr;
+    if (maxThreads) maxThreads(0xFFFFFFFFu);   // quantas o driver quiser
+
+    if (temBinario) {
+        std::error_code erro;
+        std::filesystem::create_directories(diretorioCache, erro);
+        if (erro) temBinario = false;
+    }
+    diretorio = diretorioCache;
+    uint64_t h = 1469598103934665603ull;
+    h = misturar(h, textoGL(GL_VENDOR));
+    h = misturar(h, textoGL(GL_RENDERER));
+    h = misturar(h, textoGL(GL_VERSION));
+    chaveDriver = misturar(h, textoGL(GL_SHADING_LANGUAGE_VERSION));
+}
+
+int GerenciadorProgramas::adicionar(const std::string& nome, const char* fonteVertice, const char* fonteFragmento) {
+    Programa p;
+    p.nome = nome;
+    p.vertice = fonteVertice;
+    p.fragmento = fonteFragmento;
+    p.chave = misturar(misturar(chaveDriver, fonteVertice), fonteFragmento);
+    programas.push_back(p);
+    return (int)programas.size() - 1;
+}
+
+std::string GerenciadorProgramas::arquivoCache(const Programa& p) const {
+    char nome[32];
+    std::snprintf(nome, sizeof(nome), "_%016llx.bin", (unsigned long long)p.chave);
+    return (std::filesystem::path(diretorio) / (p.nome + nome)).string();
+}
+
+bool GerenciadorProgramas::carregarBinario(Programa& p) {
+    std::string caminho = arquivoCache(p);
+    std::ifstream f(caminho, std::ios::binary);
+    if (!f.is_open()) return false;
+    char magica[4];
+    uint32_t formato = 0, tamanho = 0;
+    if (!f.read(magica, 4) || std::memcmp(magica, MAGICA, 4) != 0) return false;
+    if (!f.read((char*)&formato, 4) || !f.read((char*)&tamanho, 4)) return false;
+    // Arquivo truncado ou corrompido: o tamanho tem que ser o que sobra depois do cabeçalho
+    std::error_code erro;
+    uintmax_t bytesArquivo = std::filesystem::file_size(caminho, erro);
+    if (erro || bytesArquivo < 12 || tamanho != bytesArquivo - 12) return false;
+    std::vector<char> dados(tamanho);
+    if (!f.read(dados.data(), tamanho)) return false;
+
+    p.id = glCreateProgram();
+    pProgramBinary(p.id, formato, dados.data(), (GLsizei)tamanho);
+    GLint ok = GL_FALSE;
+    glGetProgramiv(p.id, GL_LINK_STATUS, &ok);
+    if (!ok) {   // driver recusou (atualização no meio do caminho): compila de novo
+        glDeleteProgram(p.id);
+        p.id = 0;
+        return false;
+    }
+    return true;
+}
+
+void GerenciadorProgramas::salvarBinario(const Programa& p) {
+    GLint tamanho = 0;
+    glGetProgramiv(p.id, GL_PROGRAM_BINARY_LENGTH, &tamanho);
+    if (tamanho <= 0) return;
+    std::vector<char> dados(tamanho);
+    GLenum formato = 0;
+    GLsizei escritos = 0;
+    pGetProgramBinary(p.id, tamanho, &escritos, &formato, dados.data());
+    if (escritos <= 0) return;
+    // Escreve num temporário e renomeia: duas instâncias abrindo juntas não leem binário pela metade
+    std::string destino = arquivoCache(p), temporario = destino + ".tmp";
+    {
+        std::ofstream f(temporario, std::ios::binary);
+        uint32_t fmt = formato, n = (uint32_t)escritos;
+        f.write(MAGICA, 4);
+        f.write((const char*)&fmt, 4);
+        f.write((const char*)&n, 4);
+        f.write(dados.data(), escritos);
+        if (!f) return;
+    }
+    std::error_code erro;
+    std::filesystem::rename(temporario, destino, erro);
+}
+
+bool GerenciadorProgramas::compilarTodos() {
+    RASTREIO_ESCOPO("compilar programas");
+    auto t0 = std::chrono::steady_clock::now();
+    doCache = 0;
+
+    // 1. Cache
+    if (temBinario)
+        for (auto& p : programas)
+            if (!p.pronto && carregarBinario(p)) { p.pronto = true; doCache++; }
+
+    // 2. Dispara tudo sem esperar
+    for (auto& p : programas) {
+        if (p.pronto) continue;
+        p.vs = glCreateShader(GL_VERTEX_SHADER); glShaderSource(p.vs, 1, &p.vertice, NULL); glCompileShader(p.vs);
+        p.fs = glCreateShader(GL_FRAGMENT_SHADER); glShaderSource(p.fs, 1, &p.fragmento, NULL); glCompileShader(p.fs);
+    }
+    for (auto& p : programas) {
+        if (p.pronto) continue;
+        p.id = glCreateProgram();
+        if (temBinario) pProgramParameteri(p.id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glAttachShader(p.id, p.vs); glAttachShader(p.id, p.fs);
+        glLinkProgram(p.id);
+    }
+
+    // 3. Colhe na ordem em que ficarem prontos (com o KHR) ou em sequência
+    bool tudoOk = true;
+    size_t pendentes = 0;
+    for (auto& p : programas) if (!p.pronto) pendentes++;
+    while (pendentes > 0) {
+        size_t antes = pendentes;
+        for (auto& p : programas) {
+            if (p.pronto) continue;
+            if (temParalelo) {
+                GLint completo = GL_FALSE;
+                glGetProgramiv(p.id, GL_COMPLETION_STATUS_KHR, &completo);
+                if (!completo) continue;
+            }
+            GLint ok = GL_FALSE;
+            glGetShaderiv(p.vs, GL_COMPILE_STATUS, &ok);
+            if (!ok) imprimirLog(p.nome, "compilacao do vertex shader", p.vs, false);
+            GLint okF = GL_FALSE;
+            glGetShaderiv(p.fs, GL_COMPILE_STATUS, &okF);
+            if (!okF) imprimirLog(p.nome, "compilacao do fragment shader", p.fs, false);
+            GLint okL = GL_FALSE;
+            glGetProgramiv(p.id, GL_LINK_STATUS, &okL);
+            if (ok && okF && !okL) imprimirLog(p.nome, "link", p.id, true);
+            glDeleteShader(p.vs); glDeleteShader(p.fs);
+            p.vs = p.fs = 0;
+            if (ok && okF && okL) {
+                if (temBinario) salvarBinario(p);
+            } else {
+                glDeleteProgram(p.id);
+                p.id = 0;
+                tudoOk = false;
+            }
+            p.pronto = true;
+            pendentes--;
+        }
+        // Nada ficou pronto nesta volta: cede a CPU às threads de compilação do driver
+        if (pendentes == antes) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+    ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return tudoOk;
+}
+
+void GerenciadorProgramas::liberar() {
+    for (auto& p : programas) if (p.id) glDeleteProgram(p.id);
+    programas.clear();
+}
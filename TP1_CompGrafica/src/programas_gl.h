@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+// --- PROGRAMAS GLSL ---
+// Cada variante de programa é registrada com adicionar() e todas são
+// preparadas de uma vez em compilarTodos():
+//   1. cache: se existe um binário linkado para a mesma chave (fabricante,
+//      renderer, versão do GL/GLSL e hash das fontes), glProgramBinary e pronto;
+//   2. o resto é compilado e linkado sem consultar status no meio, para o
+//      driver trabalhar em paralelo (GL_KHR_parallel_shader_compile, quando há,
+//      libera as threads dele); só depois os status são lidos e os logs de
+//      erro impressos;
+//   3. os binários novos vão para o cache (glGetProgramBinary).
+// O glad do projeto é GL 3.3 core: as funções de binário (GL 4.1 /
+// ARB_get_program_binary) e a do KHR são buscadas à mão pelo GLFW e o cache
+// simplesmente desliga se não existirem.
+class GerenciadorProgramas {
+public:
+    // Precisa do contexto ativo; 'diretorioCache' vazio desliga o cache em disco
+    void iniciar(const std::string& diretorioCache);
+    // As fontes precisam continuar vivas até compilarTodos()
+    int adicionar(const std::string& nome, const char* fonteVertice, const char* fonteFragmento);
+    // false se algum programa falhou (os erros já foram impressos); os que
+    // falharam ficam com programa() = 0
+    bool compilarTodos();
+    GLuint programa(int id) const { return programas[id].id; }
+    void liberar();
+
+    int vindosDoCache() const { return doCache; }
+    double msPreparo() const { return ms; }
+
+private:
+    struct Programa {
+        std::string nome;
+        const char* vertice = nullptr;
+        const char* fragmento = nullptr;
+        uint64_t chave = 0;
+        GLuint id = 0, vs = 0, fs = 0;
+        bool pronto = false;
+    };
+
+    std::string arquivoCache(const Programa& p) const;
+    bool carregarBinario(Programa& p);
+    void salvarBinario(const Programa& p);
+
+    std::vector<Programa> programas;
+    std::string diretorio;
+    uint64_t chaveDriver = 0;
+    bool temBinario = false, temParalelo = false;
+    int doCache = 0;
+    double ms = 0.0;
+};
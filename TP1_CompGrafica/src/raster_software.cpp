@@ -0,0 +1,94 @@
+#include "raster_software.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "grade_segmentos.h"
+#include "rastreio.h"
+
+namespace {
+
+// Clip -> pixels (y para baixo, como a imagem), z em [0, 1]
+glm::vec3 naTela(const glm::vec4& c, int largura, int altura) {
+    return glm::vec3((0.5f + 0.5f * c.x / c.w) * largura, (0.5f - 0.5f * c.y / c.w) * altura, 0.5f + 0.5f * c.z / c.w);
+}
+
+// Recorta a-b contra [0, largura) x [0, altura); false se fica tudo fora
+bool recortar(glm::vec3& a, glm::vec3& b, int largura, int altura) {
+    float t0 = 0.0f, t1 = 1.0f;
+    glm::vec3 d = b - a;
+    const float p[4] = {-d.x, d.x, -d.y, d.y};
+    const float q[4] = {a.x, largura - 1e-3f - a.x, a.y, altura - 1e-3f - a.y};
+    for (int i = 0; i < 4; i++) {
+        if (p[i] == 0.0f) { if (q[i] < 0.0f) return false; continue; }
+        float r = q[i] / p[i];
+        if (p[i] < 0.0f) t0 = std::max(t0, r);
+        else t1 = std::min(t1, r);
+        if (t0 > t1) return false;
+    }
+    glm::vec3 a0 = a;
+    a = a0 + t0 * d;
+    b = a0 + t1 * d;
+    return true;
+}
+
+} // namespace
+
+void rasterizarArvore(const Arvore2D& arvore, const glm::mat4& mvp, int largura, int altura, bool profundidade,
+                      uint8_t* rgba) {
+    RASTREIO_ESCOPO("rasterizarArvore");
+    size_t nPixels = (size_t)largura * altura;
+    for (size_t i = 0; i < nPixels; i++) {
+        rgba[4 * i] = rgba[4 * i + 1] = rgba[4 * i + 2] = 26;   // 0.1f do glClearColor
+        rgba[4 * i + 3] = 255;
+    }
+    std::vector<float> z(profundidade ? nPixels : 0, std::numeric_limits<float>::infinity());
+    int nV = (int)arvore.vertices.size();
+    for (const Segmento& s : arvore.segmentos) {
+        if (s.indicePontoA < 0 || s.indicePontoA >= nV || s.indicePontoB < 0 || s.indicePontoB >= nV) continue;
+        glm::vec4 ca = mvp * glm::vec4(arvore.vertices[s.indicePontoA].posicao, 1.0f);
+        glm::vec4 cb = mvp * glm::vec4(arvore.vertices[s.indicePontoB].posicao, 1.0f);
+        if (ca.w <= 0.0f || cb.w <= 0.0f) continue;   // atrás da câmera
+        glm::vec3 a = naTela(ca, largura, altura), b = naTela(cb, largura, altura);
+        if (!recortar(a, b, largura, altura)) continue;
+        uint8_t r = (uint8_t)(std::clamp(s.cor.r, 0.0f, 1.0f) * 255.0f + 0.5f);
+        uint8_t g = (uint8_t)(std::clamp(s.cor.g, 0.0f, 1.0f) * 255.0f + 0.5f);
+        uint8_t bl = (uint8_t)(std::clamp(s.cor.b, 0.0f, 1.0f) * 255.0f + 0.5f);
+        int passos = (int)std::ceil(std::max(std::fabs(b.x - a.x), std::fabs(b.y - a.y)));
+        glm::vec3 d = passos > 0 ? (b - a) / (float)passos : glm::vec3(0.0f);
+        glm::vec3 p = a;
+        for (int k = 0; k <= passos; k++, p += d) {
+            int x = (int)p.x, y = (int)p.y;
+            if (x < 0 || y < 0 || x >= largura || y >= altura) continue;
+            size_t i = (size_t)y * largura + x;
+            if (profundidade) {
+                if (p.z >= z[i]) continue;
+                z[i] = p.z;
+            }
+            rgba[4 * i] = r; rgba[4 * i + 1] = g; rgba[4 * i + 2] = bl;
+        }
+    }
+}
+
+int segmentoNoPixel(const Arvore2D& arvore, const glm::mat4& mvp, int largura, int altura, float x, float y,
+                    float* distanciaPx) {
+    // Mesmo critério do clique no visualizador 3D: distância em pixels na tela
+    int melhor = -1, nV = (int)arvore.vertices.size();
+    float menor = 0.0f;
+    glm::vec3 clique(x, y, 0.0f);
+    for (int s = 0; s < (int)arvore.segmentos.size(); s++) {
+        const Segmento& seg = arvore.segmentos[s];
+        if (seg.indicePontoA < 0 || seg.indicePontoA >= nV || seg.indicePontoB < 0 || seg.indicePontoB >= nV) continue;
+        glm::vec4 a = mvp * glm::vec4(arvore.vertices[seg.indicePontoA].posicao, 1.0f);
+        glm::vec4 b = mvp * glm::vec4(arvore.vertices[seg.indicePontoB].posicao, 1.0f);
+        if (a.w <= 0.0f || b.w <= 0.0f) continue;
+        glm::vec3 pa = naTela(a, largura, altura), pb = naTela(b, largura, altura);
+        pa.z = pb.z = 0.0f;
+        float d = GradeSegmentos::distanciaPontoSegmento(clique, pa, pb);
+        if (melhor < 0 || d < menor) { melhor = s; menor = d; }
+    }
+    if (distanciaPx) *distanciaPx = menor;
+    return melhor;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "arvore.h"
+
+// --- RASTERIZADOR DE LINHAS NA CPU ---
+// Para quem precisa de imagens sem janela nem contexto GL (servidor_render):
+// cada segmento é projetado com a mesma mvp do visualizador, recortado contra
+// a tela (Liang-Barsky) e desenhado com 1 pixel de largura (DDA), com
+// z-buffer em 3D. Fundo igual ao do visualizador.
+
+// 'rgba' tem largura * altura * 4 bytes, linha 0 no topo
+void rasterizarArvore(const Arvore2D& arvore, const glm::mat4& mvp, int largura, int altura, bool profundidade,
+                      uint8_t* rgba);
+
+// Segmento mais perto do pixel (x, y) (origem no topo), em pixels; -1 se nenhum
+// está na frente da câmera
+int segmentoNoPixel(const Arvore2D& arvore, const glm::mat4& mvp, int largura, int altura, float x, float y,
+                    float* distanciaPx = nullptr);
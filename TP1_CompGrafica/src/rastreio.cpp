@@ -0,0 +1,157 @@
+#include "rastreio.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+namespace rastreio {
+
+namespace {
+
+struct Evento {
+    const char* nome;
+    uint64_t inicio;
+    uint64_t duracao;   // UINT64_MAX = evento instantâneo
+};
+
+// Bloco de eventos de uma thread. Só a dona escreve; 'usados' e 'proximo' são
+// publicados com release para que gravar() possa ler enquanto a thread ainda existe.
+struct Bloco {
+    static const int CAPACIDADE = 4096;
+    Evento eventos[CAPACIDADE];
+    std::atomic<int> usados{0};
+    std::atomic<Bloco*> proximo{nullptr};
+};
+
+struct BufferThread {
+    int tid = 0;
+    std::atomic<const char*> nome{nullptr};
+    Bloco* primeiro = nullptr;
+    Bloco* atual = nullptr;
+    BufferThread* proximo = nullptr;
+};
+
+std::atomic<bool> ligado{false};
+std::string caminhoSaida;
+std::atomic<BufferThread*> buffers{nullptr};   // lista sem trava, inserção na cabeça
+std::atomic<int> proximoTid{1};
+const auto origem = std::chrono::steady_clock::now();
+
+BufferThread& meuBuffer() {
+    thread_local BufferThread* b = nullptr;
+    if (!b) {
+        b = new BufferThread();   // vive até o fim do processo, gravar() ainda lê
+        b->tid = proximoTid.fetch_add(1);
+        b->primeiro = b->atual = new Bloco();
+        BufferThread* cabeca = buffers.load(std::memory_order_relaxed);
+        do { b->proximo = cabeca; }
+        while (!buffers.compare_exchange_weak(cabeca, b, std::memory_order_release, std::memory_order_relaxed));
+    }
+    return *b;
+}
+
+void adicionar(const char* nome, uint64_t inicio, uint64_t duracao) {
+    BufferThread& b = meuBuffer();
+    int n = b.atual->usados.load(std::memory_order_relaxed);
+    if (n == Bloco::CAPACIDADE) {
+        Bloco* novo = new Bloco();
+        b.atual->proximo.store(novo, std::memory_order_release);
+        b.atual = novo;
+        n = 0;
+    }
+    b.atual->eventos[n] = {nome, inicio, duracao};
+    b.atual->usados.store(n + 1, std::memory_order_release);
+}
+
+void escreverTexto(std::ofstream& saida, const char* s) {
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') saida << '\\';
+        saida << *s;
+    }
+}
+
+} // namespace
+
+bool ativar(const std::string& caminho) {
+    if (caminho.empty()) return false;
+    caminhoSaida = caminho;
+    ligado.store(true, std::memory_order_relaxed);
+    nomearThread("principal");
+    return true;
+}
+
+void ativarPorAmbiente() {
+    const char* env = std::getenv("CCO_TRACE");
+    if (env && *env && !ativo()) ativar(env);
+}
+
+bool ativo() { return ligado.load(std::memory_order_relaxed); }
+
+uint64_t agoraUs() {
+    // +1 para que 0 continue significando "não medido" em Escopo
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - origem).count() + 1;
+}
+
+void nomearThread(const char* nome) {
+    if (!ativo()) return;
+    meuBuffer().nome.store(nome, std::memory_order_release);
+}
+
+void completo(const char* nome, uint64_t inicioUs, uint64_t fimUs) {
+    if (!ativo()) return;
+    adicionar(nome, inicioUs, fimUs >= inicioUs ? fimUs - inicioUs : 0);
+}
+
+void instante(const char* nome) {
+    if (!ativo()) return;
+    adicionar(nome, agoraUs(), UINT64_MAX);
+}
+
+bool gravar() {
+    if (!ativo()) return false;
+    std::ofstream saida(caminhoSaida);
+    if (!saida.is_open()) {
+        std::cerr << "ERRO: Nao consegui criar " << caminhoSaida << std::endl;
+        return false;
+    }
+
+    saida << "{\"traceEvents\":[\n";
+    bool primeiro = true;
+    auto separar = [&]() { if (!primeiro) saida << ",\n"; primeiro = false; };
+    size_t total = 0;
+    for (BufferThread* b = buffers.load(std::memory_order_acquire); b; b = b->proximo) {
+        const char* nome = b->nome.load(std::memory_order_acquire);
+        if (nome) {
+            separar();
+            saida << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->tid
+                  << ",\"args\":{\"name\":\"";
+            escreverTexto(saida, nome);
+            saida << "\"}}";
+        }
+        for (Bloco* bl = b->primeiro; bl; bl = bl->proximo.load(std::memory_order_acquire)) {
+            int n = bl->usados.load(std::memory_order_acquire);
+            for (int i = 0; i < n; i++) {
+                const Evento& e = bl->eventos[i];
+                separar();
+                saida << "{\"name\":\"";
+                escreverTexto(saida, e.nome);
+                if (e.duracao == UINT64_MAX)
+                    saida << "\",\"ph\":\"i\",\"s\":\"t\",\"ts\":" << e.inicio;
+                else
+                    saida << "\",\"ph\":\"X\",\"ts\":" << e.inicio << ",\"dur\":" << e.duracao;
+                saida << ",\"pid\":1,\"tid\":" << b->tid << "}";
+                total++;
+            }
+        }
+    }
+    saida << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    std::cout << "Rastreio com " << total << " eventos gravado em " << caminhoSaida << std::endl;
+    return true;
+}
+
+} // namespace rastreio
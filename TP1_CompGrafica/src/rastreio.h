@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// --- RASTREIO (formato Chrome trace / Perfetto) ---
+// Grava eventos de duração com custo mínimo: cada thread escreve no próprio
+// buffer (sem trava), e o JSON só é montado no fim, em gravar().
+// Ativado por --trace <arquivo.json> ou pela variável de ambiente CCO_TRACE.
+namespace rastreio {
+
+bool ativar(const std::string& caminho);
+void ativarPorAmbiente();       // lê CCO_TRACE, se existir
+bool ativo();
+bool gravar();                  // escreve o JSON (chamar quando as threads já terminaram)
+
+uint64_t agoraUs();
+void nomearThread(const char* nome);
+
+// Evento completo ("ph":"X"); o nome precisa viver até gravar() (use literais)
+void completo(const char* nome, uint64_t inicioUs, uint64_t fimUs);
+void instante(const char* nome);
+
+class Escopo {
+public:
+    explicit Escopo(const char* nome) : nome(nome), inicio(ativo() ? agoraUs() : 0) {}
+    ~Escopo() { if (inicio) completo(nome, inicio, agoraUs()); }
+    Escopo(const Escopo&) = delete;
+    Escopo& operator=(const Escopo&) = delete;
+private:
+    const char* nome;
+    uint64_t inicio;
+};
+
+} // namespace rastreio
+
+#define RASTREIO_CONCAT2(a, b) a##b
+#define RASTREIO_CONCAT(a, b) RASTREIO_CONCAT2(a, b)
+#define RASTREIO_ESCOPO(nome) rastreio::Escopo RASTREIO_CONCAT(_rastreio_, __LINE__)(nome)
@@ -0,0 +1,100 @@
+#include "refinamento.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "rastreio.h"
+
+void RefinamentoProgressivo::iniciar(bool profundidade, double orcamentoMs) {
+    comProfundidade = profundidade;
+    orcamento = orcamentoMs;
+    glGenFramebuffers(1, &fbo);
+    for (auto& c : consultas) glGenQueries(2, c);
+    iniciado = true;
+}
+
+void RefinamentoProgressivo::liberar() {
+    if (!iniciado) return;
+    for (auto& c : consultas) glDeleteQueries(2, c);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &cor);
+    if (profundidadeRb) glDeleteRenderbuffers(1, &profundidadeRb);
+    cor = profundidadeRb = 0;
+    iniciado = false;
+}
+
+void RefinamentoProgressivo::redimensionar(int w, int h) {
+    if (!cor) glGenTextures(1, &cor);
+    glBindTexture(GL_TEXTURE_2D, cor);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, cor, 0);
+    if (comProfundidade) {
+        if (!profundidadeRb) glGenRenderbuffers(1, &profundidadeRb);
+        glBindRenderbuffer(GL_RENDERBUFFER, profundidadeRb);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, w, h);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, profundidadeRb);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    largura = w; altura = h;
+}
+
+void RefinamentoProgressivo::lerTempos() {
+    // O frame mais antigo do anel; se ainda não chegou, fica para o próximo
+    if (frame < LATENCIA) return;
+    int i = (int)(frame % LATENCIA);
+    if (segmentosNoFrame[i] <= 0) return;
+    GLint pronto = 0;
+    glGetQueryObjectiv(consultas[i][1], GL_QUERY_RESULT_AVAILABLE, &pronto);
+    if (!pronto) return;
+    GLuint64 t0 = 0, t1 = 0;
+    glGetQueryObjectui64v(consultas[i][0], GL_QUERY_RESULT, &t0);
+    glGetQueryObjectui64v(consultas[i][1], GL_QUERY_RESULT, &t1);
+    double ms = (double)(t1 - t0) / 1e6;
+    if (ms > 0.0) {
+        double ritmo = segmentosNoFrame[i] / ms;
+        segmentosPorMs = segmentosPorMs > 0.0 ? 0.8 * segmentosPorMs + 0.2 * ritmo : ritmo;
+        // Sem saltos bruscos de um frame para o outro
+        loteAtual = std::clamp(segmentosPorMs * orcamento, loteAtual * 0.5, loteAtual * 2.0);
+        loteAtual = std::max(loteAtual, 1024.0);
+    }
+    segmentosNoFrame[i] = 0;
+}
+
+bool RefinamentoProgressivo::desenhar(const glm::mat4& mvp, int w, int h, int total, const DesenharFaixa& desenharFaixa) {
+    RASTREIO_ESCOPO("refinamento");
+    if (w <= 0 || h <= 0) return false;
+    if (w != largura || h != altura) { redimensionar(w, h); sujo = true; }
+    if (total != ultimoTotal || std::memcmp(&mvp, &ultimaMvp, sizeof(glm::mat4)) != 0) sujo = true;
+    ultimaMvp = mvp;
+    ultimoTotal = total;
+    lerTempos();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    if (sujo) {
+        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        glClear(comProfundidade ? GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT : GL_COLOR_BUFFER_BIT);
+        cursor = 0;
+        sujo = false;
+    }
+    int quantidade = std::min(total - cursor, (int)loteAtual);
+    int i = (int)(frame % LATENCIA);
+    if (quantidade > 0) {
+        glQueryCounter(consultas[i][0], GL_TIMESTAMP);
+        desenharFaixa(cursor, quantidade);
+        glQueryCounter(consultas[i][1], GL_TIMESTAMP);
+        segmentosNoFrame[i] = quantidade;
+        cursor += quantidade;
+    } else {
+        segmentosNoFrame[i] = 0;
+    }
+    frame++;
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return cursor < total;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// --- REFINAMENTO PROGRESSIVO ---
+// Para árvores que não cabem num frame: o buffer está em ordem de importância
+// (raio decrescente, ver montarCena), e cada frame desenha só o próximo lote
+// num alvo de acumulação (cor + profundidade), que é copiado para a tela. A
+// câmera parada faz a imagem ir ficando completa; qualquer mudança de câmera,
+// de tamanho ou de dados recomeça do tronco.
+//
+// O tamanho do lote segue o orçamento em ms medido na GPU: dois carimbos de
+// tempo (GL_TIMESTAMP, que pode ficar dentro do GL_TIME_ELAPSED do perfilador)
+// por frame, lidos com alguns frames de atraso para não travar o pipeline.
+class RefinamentoProgressivo {
+public:
+    // desenharFaixa(primeiro, quantidade): segmentos na ordem do buffer
+    using DesenharFaixa = std::function<void(int, int)>;
+
+    void iniciar(bool profundidade, double orcamentoMs);
+    void liberar();
+    void reiniciar() { cursor = 0; sujo = true; }
+
+    // Desenha o próximo lote (recomeçando se 'mvp' ou o tamanho mudou) e copia
+    // para a tela; true enquanto faltar segmento dos 'total' primeiros
+    bool desenhar(const glm::mat4& mvp, int w, int h, int total, const DesenharFaixa& desenharFaixa);
+
+    int desenhados() const { return cursor; }
+    int lote() const { return (int)loteAtual; }
+
+private:
+    static const int LATENCIA = 4;
+
+    void redimensionar(int w, int h);
+    void lerTempos();
+
+    bool iniciado = false, comProfundidade = false, sujo = true;
+    double orcamento = 8.0;
+    GLuint fbo = 0, cor = 0, profundidadeRb = 0;
+    int largura = 0, altura = 0;
+    glm::mat4 ultimaMvp = glm::mat4(0.0f);
+    int ultimoTotal = -1;
+    int cursor = 0;
+
+    // Ritmo medido: segmentos por ms de GPU (média móvel)
+    double loteAtual = 65536.0, segmentosPorMs = 0.0;
+    GLuint consultas[LATENCIA][2] = {};
+    int segmentosNoFrame[LATENCIA] = {};
+    uint64_t frame = 0;
+};
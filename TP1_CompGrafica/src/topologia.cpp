@@ -0,0 +1,130 @@
+#include "topologia.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "pool_tarefas.h"
+#include "rastreio.h"
+
+namespace {
+
+const int GRAO = 16384;   // abaixo disso um passe roda em série
+
+} // namespace
+
+Topologia montarTopologia(const Arvore2D& arvore, int threads, std::pmr::memory_resource* recurso) {
+    PoolTarefas pool(threads);
+    return montarTopologia(arvore, pool, recurso);
+}
+
+Topologia montarTopologia(const Arvore2D& arvore, PoolTarefas& pool, std::pmr::memory_resource* recurso) {
+    RASTREIO_ESCOPO("montarTopologia");
+    const auto& segs = arvore.segmentos;
+    int n = (int)segs.size(), nV = (int)arvore.vertices.size();
+    Topologia t(recurso);
+
+    // 1. Pai: o segmento que termina no vértice onde s começa. Em série: dois
+    //    segmentos no mesmo vértice final (arquivo com segmento repetido ou
+    //    invertido) disputariam fimEm[b]; assim fica sempre o de maior índice
+    std::vector<int> fimEm(nV, -1);
+    for (int s = 0; s < n; s++) {
+        int b = segs[s].indicePontoB;
+        if (b >= 0 && b < nV) fimEm[b] = s;
+    }
+    t.pai.resize(n);
+    pool.paraBlocos(n, GRAO, [&](int i0, int i1) {
+        for (int s = i0; s < i1; s++) {
+            int a = segs[s].indicePontoA;
+            t.pai[s] = (a >= 0 && a < nV && fimEm[a] != s) ? fimEm[a] : -1;
+        }
+    });
+    std::vector<int>().swap(fimEm);
+
+    // 2. Filhos em CSR: contagem atômica, soma de prefixos por blocos e preenchimento
+    std::unique_ptr<std::atomic<int>[]> contagem(new std::atomic<int>[n + 1]);
+    pool.paraBlocos(n + 1, GRAO, [&](int i0, int i1) {
+        for (int s = i0; s < i1; s++) contagem[s].store(0, std::memory_order_relaxed);
+    });
+    pool.paraBlocos(n, GRAO, [&](int i0, int i1) {
+        for (int s = i0; s < i1; s++)
+            if (t.pai[s] >= 0) contagem[t.pai[s]].fetch_add(1, std::memory_order_relaxed);
+    });
+    t.inicioFilhos.resize(n + 1);
+    std::vector<int> somaBloco((n + GRAO - 1) / GRAO + 1, 0);
+    pool.paraBlocos(n, GRAO, [&](int i0, int i1) {
+        int soma = 0;
+        for (int s = i0; s < i1; s++) soma += contagem[s].load(std::memory_order_relaxed);
+        somaBloco[i0 / GRAO + 1] = soma;
+    });
+    for (size_t b = 1; b < somaBloco.size(); b++) somaBloco[b] += somaBloco[b - 1];
+    pool.paraBlocos(n, GRAO, [&](int i0, int i1) {
+        int soma = somaBloco[i0 / GRAO];
+        for (int s = i0; s < i1; s++) {
+            t.inicioFilhos[s] = soma;
+            soma += contagem[s].load(std::memory_order_relaxed);
+            contagem[s].store(0, std::memory_order_relaxed);   // vira cursor
+        }
+    });
+    t.inicioFilhos[n] = somaBloco.back();
+    t.filhos.resize(t.inicioFilhos[n]);
+    pool.paraBlocos(n, GRAO, [&](int i0, int i1) {
+        for (int s = i0; s < i1; s++) {
+            int p = t.pai[s];
+            if (p >= 0) t.filhos[t.inicioFilhos[p] + contagem[p].fetch_add(1, std::memory_order_relaxed)] = s;
+        }
+    });
+    contagem.reset();
+    // A ordem de chegada depende das threads; ordena para ficar determinístico
+    pool.paraBlocos(n, GRAO, [&](int i0, int i1) {
+        for (int s = i0; s < i1; s++)
+            if (t.nFilhos(s) > 1) std::sort(t.filhos.begin() + t.inicioFilhos[s], t.filhos.begin() + t.inicioFilhos[s + 1]);
+    });
+
+    // 3. Níveis em largura a partir das raízes
+    // Arena monotônica não reaproveita o que o vector larga ao crescer: conta antes
+    t.raizes.reserve(std::count(t.pai.begin(), t.pai.end(), -1));
+    for (int s = 0; s < n; s++) if (t.pai[s] < 0) t.raizes.push_back(s);
+    t.ordem.reserve(n);
+    t.ordem.insert(t.ordem.end(), t.raizes.begin(), t.raizes.end());
+    // O número de níveis só se sabe no fim: os inícios vão num vector de trabalho
+    std::vector<int> inicios(1, 0);
+    for (size_t ini = 0; ini < t.ordem.size();) {
+        size_t fim = t.ordem.size();
+        inicios.push_back((int)fim);
+        for (size_t i = ini; i < fim; i++) {
+            int s = t.ordem[i];
+            t.ordem.insert(t.ordem.end(), t.filhosDe(s), t.filhosDe(s) + t.nFilhos(s));
+        }
+        ini = fim;
+    }
+    t.inicioNivel.assign(inicios.begin(), inicios.end());
+
+    // 4. Profundidade por nível; tamanho e Strahler do nível mais fundo para cima
+    t.profundidade.assign(n, -1);
+    t.tamanho.assign(n, 0);
+    t.strahler.assign(n, 0);
+    for (int nivel = 0; nivel < t.nNiveis(); nivel++) {
+        const int* ordem = t.ordem.data() + t.inicioNivel[nivel];
+        pool.paraBlocos(t.inicioNivel[nivel + 1] - t.inicioNivel[nivel], GRAO, [&](int i0, int i1) {
+            for (int i = i0; i < i1; i++) t.profundidade[ordem[i]] = nivel;
+        });
+    }
+    for (int nivel = t.nNiveis() - 1; nivel >= 0; nivel--) {
+        const int* ordem = t.ordem.data() + t.inicioNivel[nivel];
+        pool.paraBlocos(t.inicioNivel[nivel + 1] - t.inicioNivel[nivel], GRAO, [&](int i0, int i1) {
+            for (int i = i0; i < i1; i++) {
+                int s = ordem[i], tamanho = 1, maior = 0, empates = 0;
+                for (int k = 0; k < t.nFilhos(s); k++) {
+                    int f = t.filhosDe(s)[k];
+                    tamanho += t.tamanho[f];
+                    if (t.strahler[f] > maior) { maior = t.strahler[f]; empates = 1; }
+                    else if (t.strahler[f] == maior) empates++;
+                }
+                t.tamanho[s] = tamanho;
+                t.strahler[s] = maior == 0 ? 1 : (empates > 1 ? maior + 1 : maior);
+            }
+        });
+    }
+    return t;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory_resource>
+#include <vector>
+
+#include "arvore.h"
+
+class PoolTarefas;
+
+// --- TOPOLOGIA ---
+// Arvore2D é só uma lista de arestas; este índice guarda a adjacência por
+// segmento, montado uma vez por árvore em tempo linear:
+//   pai           segmento que termina onde s começa (-1 nas raízes)
+//   filhos (CSR)  filhos[inicioFilhos[s] .. inicioFilhos[s + 1]), em ordem crescente
+//   profundidade  geração (raiz = 0)
+//   strahler      1 nos terminais; sobe quando dois filhos empatam no máximo
+//   tamanho       segmentos da subárvore, contando s
+//   ordem         segmentos em largura; o nível k é ordem[inicioNivel[k] .. inicioNivel[k + 1])
+// Segmentos presos em ciclos (arquivo inválido) não entram em 'ordem' e ficam
+// com profundidade -1.
+struct Topologia {
+    std::pmr::vector<int> raizes;
+    std::pmr::vector<int> pai;
+    std::pmr::vector<int> inicioFilhos, filhos;
+    std::pmr::vector<int> profundidade;
+    std::pmr::vector<int> strahler;
+    std::pmr::vector<int> tamanho;
+    std::pmr::vector<int> ordem, inicioNivel;
+
+    explicit Topologia(std::pmr::memory_resource* r = std::pmr::get_default_resource())
+        : raizes(r), pai(r), inicioFilhos(r), filhos(r), profundidade(r), strahler(r), tamanho(r), ordem(r), inicioNivel(r) {}
+
+    int nSegmentos() const { return (int)pai.size(); }
+    int nNiveis() const { return inicioNivel.empty() ? 0 : (int)inicioNivel.size() - 1; }
+    int nFilhos(int s) const { return inicioFilhos[s + 1] - inicioFilhos[s]; }
+    const int* filhosDe(int s) const { return filhos.data() + inicioFilhos[s]; }
+    bool terminal(int s) const { return nFilhos(s) == 0; }
+};
+
+// As contagens e os passes por nível rodam em paralelo ('threads' = 0: todos os núcleos).
+// Os arrays saem de 'recurso' (a arena da árvore, se a topologia viver tanto quanto ela)
+Topologia montarTopologia(const Arvore2D& arvore, int threads = 0,
+                          std::pmr::memory_resource* recurso = std::pmr::get_default_resource());
+Topologia montarTopologia(const Arvore2D& arvore, PoolTarefas& pool,
+                          std::pmr::memory_resource* recurso = std::pmr::get_default_resource());
@@ -0,0 +1,348 @@
+// --- BENCHMARK DOS CARREGADORES ---
+// Mede cada caminho de carga (carregarVTK original, carregarVTKRapido e o cache
+// binário) sobre todos os .vtk de TP_CCO_Pacote_Dados e sobre entradas sintéticas
+// de até 10M segmentos; os carregadores novos também com a árvore numa
+// ArenaArvore. Sai em JSON: MB/s, segmentos/s, alocações e pico de RSS.
+// Sobre as mesmas árvores, confere os kernels de ArvoreSoA contra os laços
+// escalares em Arvore2D e mede os dois lados (compare com ARVORE_NATIVO).
+//
+// Uso: ./bench_loader [--dados <dir>] [--max-segmentos N] [--repeticoes N]
+//                     [--tmp <dir>] [--saida <arquivo.json>]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "arena_arvore.h"
+#include "arvore.h"
+#include "arvore_soa.h"
+#include "carregador_vtk.h"
+
+namespace fs = std::filesystem;
+
+// --- CONTAGEM DE ALOCAÇÕES ---
+static std::atomic<size_t> totalAlocacoes{0};
+static std::atomic<size_t> totalBytes{0};
+
+void* operator new(size_t n) {
+    totalAlocacoes.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add(n, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+// Versões alinhadas: o recurso pmr padrão (new_delete_resource) aloca por elas
+void* operator new(size_t n, std::align_val_t alinhamento) {
+    totalAlocacoes.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add(n, std::memory_order_relaxed);
+    size_t a = std::max(sizeof(void*), (size_t)alinhamento);
+    if (void* p = std::aligned_alloc(a, (std::max<size_t>(n, 1) + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t n, std::align_val_t alinhamento) { return operator new(n, alinhamento); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+// --- PICO DE RSS ---
+// Zera o pico (VmHWM) antes de cada medição; sem permissão, fica o pico do processo
+static void zerarPicoRSS() {
+    std::ofstream f("/proc/self/clear_refs");
+    if (f.is_open()) f << "5";
+}
+
+static long picoRSSkB() {
+    std::ifstream f("/proc/self/status");
+    std::string linha;
+    while (std::getline(f, linha))
+        if (linha.compare(0, 6, "VmHWM:") == 0) return std::atol(linha.c_str() + 6);
+    return -1;
+}
+
+// --- ENTRADAS SINTÉTICAS ---
+// Árvore aleatória simples: cada ponto novo nasce perto de um ponto anterior
+static void gerarVTKSintetico(const std::string& caminho, int nSegmentos) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> desvio(-0.01f, 0.01f);
+    std::vector<glm::vec3> pontos;
+    std::vector<int> pais;
+    pontos.reserve(nSegmentos + 1);
+    pais.reserve(nSegmentos);
+    pontos.push_back(glm::vec3(0.0f, 0.05f, 0.0f));
+    for (int i = 0; i < nSegmentos; i++) {
+        int pai = std::uniform_int_distribution<int>(0, (int)pontos.size() - 1)(rng);
+        pontos.push_back(pontos[pai] + glm::vec3(desvio(rng), desvio(rng), 0.0f));
+        pais.push_back(pai);
+    }
+
+    FILE* f = std::fopen(caminho.c_str(), "w");
+    if (!f) { std::cerr << "ERRO: Nao consegui criar " << caminho << std::endl; return; }
+    std::fprintf(f, "# vtk DataFile Version 3.0\nvtk output\nASCII\nDATASET POLYDATA\n");
+    std::fprintf(f, "POINTS  %d  float\n", (int)pontos.size());
+    for (const auto& p : pontos) std::fprintf(f, "%.7f  %.7f  %.7f\n", p.x, p.y, p.z);
+    std::fprintf(f, "\nLINES  %d  %d\n", nSegmentos, nSegmentos * 3);
+    for (int i = 0; i < nSegmentos; i++) std::fprintf(f, "2  %d  %d\n", pais[i], i + 1);
+    std::fprintf(f, "\nCELL_DATA  %d\nscalars raio float\nLOOKUP_TABLE default\n", nSegmentos);
+    for (int i = 0; i < nSegmentos; i++) std::fprintf(f, "%.7f\n", 0.1f + 0.9f * (float)rng() / (float)rng.max());
+    std::fclose(f);
+}
+
+// --- MEDIÇÃO ---
+struct Resultado {
+    std::string arquivo, carregador;
+    size_t bytes = 0, segmentos = 0, vertices = 0;
+    int repeticoes = 0;
+    double segMin = 0.0, segMediana = 0.0;
+    size_t alocacoes = 0, bytesAlocados = 0;
+    long picoRSS = -1;
+    bool confere = true;
+};
+
+static bool mesmaArvore(const Arvore2D& a, const Arvore2D& b) {
+    if (a.vertices.size() != b.vertices.size() || a.segmentos.size() != b.segmentos.size()) return false;
+    for (size_t i = 0; i < a.vertices.size(); i++)
+        if (a.vertices[i].posicao != b.vertices[i].posicao) return false;
+    for (size_t i = 0; i < a.segmentos.size(); i++) {
+        const Segmento& x = a.segmentos[i]; const Segmento& y = b.segmentos[i];
+        if (x.indicePontoA != y.indicePontoA || x.indicePontoB != y.indicePontoB || x.raio != y.raio) return false;
+    }
+    return true;
+}
+
+using Carregador = std::function<Arvore2D(const std::string&, std::pmr::memory_resource*)>;
+
+static Resultado medir(const std::string& nome, const std::string& caminho, const Carregador& carregar,
+                       int repeticoes, const Arvore2D* referencia, bool usarArena = false) {
+    Resultado r;
+    r.arquivo = caminho; r.carregador = nome; r.repeticoes = repeticoes;
+    r.bytes = fs::file_size(caminho);
+    std::vector<double> tempos;
+    for (int i = 0; i < repeticoes; i++) {
+        zerarPicoRSS();
+        size_t aloc0 = totalAlocacoes.load(), bytes0 = totalBytes.load();
+        auto t0 = std::chrono::steady_clock::now();
+        // Criar a arena entra na conta; a descarga (um munmap por bloco) fica no fim da iteração
+        std::unique_ptr<ArenaArvore> arena(usarArena ? new ArenaArvore(r.bytes) : nullptr);
+        Arvore2D a = carregar(caminho, arena ? arena->recurso() : std::pmr::get_default_resource());
+        auto t1 = std::chrono::steady_clock::now();
+        tempos.push_back(std::chrono::duration<double>(t1 - t0).count());
+        if (i == 0) {
+            r.alocacoes = totalAlocacoes.load() - aloc0;
+            r.bytesAlocados = totalBytes.load() - bytes0;
+            r.picoRSS = picoRSSkB();
+            r.vertices = a.vertices.size();
+            r.segmentos = a.segmentos.size();
+            if (referencia) r.confere = mesmaArvore(a, *referencia);
+        }
+    }
+    std::sort(tempos.begin(), tempos.end());
+    r.segMin = tempos.front();
+    r.segMediana = tempos[tempos.size() / 2];
+    return r;
+}
+
+// --- KERNELS SoA ---
+struct ResultadoKernel {
+    std::string arquivo, kernel;
+    double segSoA = 0.0, segAoS = 0.0;   // melhor de 'repeticoes'
+    bool confere = true;
+};
+
+template <typename F>
+static double melhorTempo(int repeticoes, F&& f) {
+    double melhor = 1e30;
+    for (int i = 0; i < repeticoes; i++) {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        melhor = std::min(melhor, std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+    }
+    return melhor;
+}
+
+// Iguais a menos do arredondamento (FMA contraído de um lado e não do outro)
+static bool quase(float a, float b) { return std::fabs(a - b) <= 1e-5f * (1.0f + std::fabs(b)); }
+
+static void medirKernels(const std::string& caminho, const Arvore2D& arvore, int repeticoes,
+                         std::vector<ResultadoKernel>& saida) {
+    size_t nV = arvore.vertices.size(), nS = arvore.segmentos.size();
+    if (nV == 0 || nS == 0) return;
+    ResultadoKernel r;
+    r.arquivo = caminho;
+
+    // Conversão: contra uma cópia simples de Arvore2D; a volta tem que dar a mesma árvore
+    ArvoreSoA soa;
+    r.kernel = "paraSoA";
+    r.segSoA = melhorTempo(repeticoes, [&]() { soa = paraSoA(arvore); });
+    r.segAoS = melhorTempo(repeticoes, [&]() { Arvore2D copia = arvore; (void)copia; });
+    r.confere = mesmaArvore(paraArvore2D(soa), arvore);
+    saida.push_back(r);
+
+    CaixaEnvolvente caixa;
+    glm::vec3 mn, mx;
+    r.kernel = "caixaEnvolvente";
+    r.segSoA = melhorTempo(repeticoes, [&]() { caixa = caixaEnvolvente(soa); });
+    r.segAoS = melhorTempo(repeticoes, [&]() {
+        mn = mx = arvore.vertices[0].posicao;
+        for (const Ponto& p : arvore.vertices) { mn = glm::min(mn, p.posicao); mx = glm::max(mx, p.posicao); }
+    });
+    r.confere = caixa.minimo == mn && caixa.maximo == mx;
+    saida.push_back(r);
+
+    float rMin = 0.0f, rMax = 0.0f, eMin = 0.0f, eMax = 0.0f;
+    r.kernel = "faixaRaio";
+    r.segSoA = melhorTempo(repeticoes, [&]() { faixaRaio(soa, rMin, rMax); });
+    r.segAoS = melhorTempo(repeticoes, [&]() {
+        eMin = eMax = arvore.segmentos[0].raio;
+        for (const Segmento& sg : arvore.segmentos) { eMin = std::min(eMin, sg.raio); eMax = std::max(eMax, sg.raio); }
+    });
+    r.confere = rMin == eMin && rMax == eMax;
+    saida.push_back(r);
+
+    std::vector<float> comp(nS), esperado(nS);
+    r.kernel = "comprimentosSegmentos";
+    r.segSoA = melhorTempo(repeticoes, [&]() { comprimentosSegmentos(soa, comp.data()); });
+    r.segAoS = melhorTempo(repeticoes, [&]() {
+        for (size_t i = 0; i < nS; i++) {
+            const Segmento& sg = arvore.segmentos[i];
+            esperado[i] = glm::length(arvore.vertices[sg.indicePontoB].posicao - arvore.vertices[sg.indicePontoA].posicao);
+        }
+    });
+    r.confere = true;
+    for (size_t i = 0; i < nS && r.confere; i++) r.confere = quase(comp[i], esperado[i]);
+    saida.push_back(r);
+
+    // Transformação afim qualquer (rotação + escala + translação)
+    glm::mat4 m(1.0f);
+    m[0] = glm::vec4(0.8f, 0.6f, 0.0f, 0.0f);
+    m[1] = glm::vec4(-0.6f, 0.8f, 0.0f, 0.0f);
+    m[2] = glm::vec4(0.0f, 0.0f, 2.0f, 0.0f);
+    m[3] = glm::vec4(1.0f, -2.0f, 0.5f, 1.0f);
+    std::vector<float> ox(nV), oy(nV), oz(nV);
+    std::vector<glm::vec3> transformados(nV);
+    r.kernel = "transformarVertices";
+    r.segSoA = melhorTempo(repeticoes, [&]() { transformarVertices(soa, m, ox.data(), oy.data(), oz.data()); });
+    r.segAoS = melhorTempo(repeticoes, [&]() {
+        for (size_t i = 0; i < nV; i++) transformados[i] = glm::vec3(m * glm::vec4(arvore.vertices[i].posicao, 1.0f));
+    });
+    r.confere = true;
+    for (size_t i = 0; i < nV && r.confere; i++)
+        r.confere = quase(ox[i], transformados[i].x) && quase(oy[i], transformados[i].y) && quase(oz[i], transformados[i].z);
+    saida.push_back(r);
+}
+
+static std::string textoJSON(const std::string& s) {
+    std::string r;
+    for (char c : s) { if (c == '"' || c == '\\') r += '\\'; r += c; }
+    return r;
+}
+
+int main(int argc, char* argv[]) {
+    std::string dirDados = "../TP_CCO_Pacote_Dados";
+    std::string dirTmp = fs::temp_directory_path().string();
+    std::string caminhoSaida;
+    long maxSegmentos = 10000000;
+    int repeticoes = 5;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--dados" && i + 1 < argc) dirDados = argv[++i];
+        else if (arg == "--max-segmentos" && i + 1 < argc) maxSegmentos = std::atol(argv[++i]);
+        else if (arg == "--repeticoes" && i + 1 < argc) repeticoes = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--tmp" && i + 1 < argc) dirTmp = argv[++i];
+        else if (arg == "--saida" && i + 1 < argc) caminhoSaida = argv[++i];
+        else {
+            std::cout << "Uso: ./bench_loader [--dados <dir>] [--max-segmentos N] [--repeticoes N] [--tmp <dir>] [--saida <arquivo.json>]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Entradas: dados do pacote (ordenados) + sintéticas em escala
+    std::vector<std::string> entradas;
+    if (fs::is_directory(dirDados)) {
+        for (const auto& e : fs::recursive_directory_iterator(dirDados))
+            if (e.is_regular_file() && e.path().extension() == ".vtk") entradas.push_back(e.path().string());
+        std::sort(entradas.begin(), entradas.end());
+    } else {
+        std::cerr << "Aviso: diretorio de dados " << dirDados << " nao encontrado" << std::endl;
+    }
+    std::vector<std::string> sinteticas;
+    for (long n = 10000; n <= maxSegmentos; n *= 10) {
+        std::string caminho = (fs::path(dirTmp) / ("bench_sintetico_" + std::to_string(n) + ".vtk")).string();
+        if (!fs::exists(caminho)) {
+            std::cerr << "Gerando " << caminho << "..." << std::endl;
+            gerarVTKSintetico(caminho, (int)n);
+        }
+        entradas.push_back(caminho);
+        sinteticas.push_back(caminho);
+    }
+
+    std::vector<Resultado> resultados;
+    std::vector<ResultadoKernel> kernels;
+    for (const auto& caminho : entradas) {
+        std::cerr << "Medindo " << caminho << std::endl;
+        // Arquivos grandes: menos repetições, o tempo já é estável
+        int reps = fs::file_size(caminho) > (64u << 20) ? std::min(repeticoes, 2) : repeticoes;
+        Arvore2D referencia = carregarVTK(caminho);
+        auto original = [](const std::string& c, std::pmr::memory_resource*) { return carregarVTK(c); };
+        resultados.push_back(medir("carregarVTK", caminho, original, reps, nullptr));
+        resultados.push_back(medir("carregarVTKRapido", caminho, carregarVTKRapido, reps, &referencia));
+        resultados.push_back(medir("carregarVTKRapido+arena", caminho, carregarVTKRapido, reps, &referencia, true));
+
+        std::string cache = (fs::path(dirTmp) / (fs::path(caminho).stem().string() + ".arvb")).string();
+        salvarCacheArvore(referencia, cache);
+        resultados.push_back(medir("carregarCacheArvore", cache, carregarCacheArvore, reps, &referencia));
+        resultados.push_back(medir("carregarCacheArvore+arena", cache, carregarCacheArvore, reps, &referencia, true));
+        fs::remove(cache);
+        medirKernels(caminho, referencia, reps, kernels);
+    }
+    for (const auto& s : sinteticas) fs::remove(s);
+
+    std::ostringstream json;
+    json << "{\n  \"resultados\": [\n";
+    for (size_t i = 0; i < resultados.size(); i++) {
+        const Resultado& r = resultados[i];
+        double mb = r.bytes / (1024.0 * 1024.0);
+        json << "    {\"arquivo\": \"" << textoJSON(r.arquivo) << "\", \"carregador\": \"" << r.carregador << "\""
+             << ", \"bytes\": " << r.bytes << ", \"vertices\": " << r.vertices << ", \"segmentos\": " << r.segmentos
+             << ", \"repeticoes\": " << r.repeticoes
+             << ", \"segundos_min\": " << r.segMin << ", \"segundos_mediana\": " << r.segMediana
+             << ", \"mb_s\": " << mb / r.segMediana << ", \"segmentos_s\": " << r.segmentos / r.segMediana
+             << ", \"alocacoes\": " << r.alocacoes << ", \"bytes_alocados\": " << r.bytesAlocados
+             << ", \"pico_rss_kb\": " << r.picoRSS << ", \"confere\": " << (r.confere ? "true" : "false") << "}"
+             << (i + 1 < resultados.size() ? "," : "") << "\n";
+    }
+    json << "  ],\n  \"kernels\": [\n";
+    for (size_t i = 0; i < kernels.size(); i++) {
+        const ResultadoKernel& k = kernels[i];
+        json << "    {\"arquivo\": \"" << textoJSON(k.arquivo) << "\", \"kernel\": \"" << k.kernel << "\""
+             << ", \"segundos_soa\": " << k.segSoA << ", \"segundos_aos\": " << k.segAoS
+             << ", \"confere\": " << (k.confere ? "true" : "false") << "}" << (i + 1 < kernels.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+
+    if (caminhoSaida.empty()) std::cout << json.str();
+    else {
+        std::ofstream f(caminhoSaida);
+        f << json.str();
+        std::cerr << "Resultados gravados em " << caminhoSaida << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+// --- CRESCIMENTO CCO ---
+// Cresce uma árvore pelo CCO e grava os passos intermediários no mesmo formato
+// e com os mesmos nomes dos arquivos do pacote (tree2D_Nterm0256_step0032.vtk),
+// então a saída pode ser aberta direto no visualizador.
+//
+// Uso: ./crescer_cco [--terminais N] [--dim 2|3] [--passo K] [--saida-dir <dir>]
+//                    [--semente S] [--candidatos k] [--threads T]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "cco.h"
+#include "escritor_vtk.h"
+
+namespace {
+
+std::string nomePasso(const std::string& dir, int dimensao, int nTerminais, int passo) {
+    char nome[64];
+    std::snprintf(nome, sizeof(nome), "tree%dD_Nterm%04d_step%04d.vtk", dimensao, nTerminais, passo);
+    return dir.empty() ? nome : dir + "/" + nome;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ParametrosCCO prm;
+    int passo = 0;
+    std::string dir;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--terminais" && i + 1 < argc) prm.nTerminais = std::atoi(argv[++i]);
+        else if (arg == "--dim" && i + 1 < argc) prm.dimensao = std::atoi(argv[++i]);
+        else if (arg == "--passo" && i + 1 < argc) passo = std::atoi(argv[++i]);
+        else if (arg == "--saida-dir" && i + 1 < argc) dir = argv[++i];
+        else if (arg == "--semente" && i + 1 < argc) prm.semente = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--candidatos" && i + 1 < argc) prm.candidatos = std::atoi(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) prm.threads = std::atoi(argv[++i]);
+        else {
+            std::cout << "Uso: ./crescer_cco [--terminais N] [--dim 2|3] [--passo K] [--saida-dir <dir>]"
+                         " [--semente S] [--candidatos k] [--threads T]" << std::endl;
+            return 1;
+        }
+    }
+    if ((prm.dimensao != 2 && prm.dimensao != 3) || prm.nTerminais < 1 || prm.candidatos < 1) {
+        std::cerr << "Parametros invalidos" << std::endl;
+        return 1;
+    }
+    // Sem --passo grava só a árvore final
+    if (passo <= 0) passo = prm.nTerminais;
+
+    ArvoreCCO arvore(prm);
+    auto t0 = std::chrono::steady_clock::now();
+    double segundosGravando = 0.0;
+    while (arvore.terminais() < prm.nTerminais) {
+        if (!arvore.adicionarTerminal()) {
+            std::cerr << "Sem lugar para o terminal " << arvore.terminais() + 1 << std::endl;
+            break;
+        }
+        int n = arvore.terminais();
+        if (n % passo == 0 || n == prm.nTerminais) {
+            auto g0 = std::chrono::steady_clock::now();
+            std::string caminho = nomePasso(dir, prm.dimensao, prm.nTerminais, n);
+            if (!salvarVTK(arvore.paraArvore(), caminho)) return 1;
+            segundosGravando += std::chrono::duration<double>(std::chrono::steady_clock::now() - g0).count();
+        }
+    }
+    double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "Crescidos " << arvore.terminais() << " terminais (" << arvore.segmentos() << " segmentos, "
+              << prm.dimensao << "D) em " << total - segundosGravando << " s; gravacao " << segundosGravando
+              << " s; volume " << arvore.volume() * 1e6 << " cm^3" << std::endl;
+    return 0;
+}
@@ -0,0 +1,239 @@
+// --- GERADOR DE ÁRVORES SINTÉTICAS ---
+// Gera árvores binárias parecidas com as do CCO, em 2D ou 3D, de 10^4 a 10^8
+// segmentos, para testar carregadores e renderizadores em escala.
+//
+// Raios seguem a lei de Murray com fluxo igual por terminal (r ~ n^(1/3), então
+// r0^3 = r1^3 + r2^3 em toda bifurcação) e os ângulos das filhas seguem o ótimo
+// de Murray para esses raios. Cada subárvore usa uma semente derivada da do pai,
+// então o resultado não depende do número de threads.
+//
+// Uso: ./gerar_arvore --segmentos N [--dim 2|3] [--formato ascii|binary|cache]
+//                     [--saida <arquivo>] [--semente S] [--threads T]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "carregador_vtk.h"
+#include "escritor_vtk.h"
+
+namespace {
+
+const float RAIO_RAIZ = 0.7f;      // mesma ordem do raio da raiz nos arquivos do pacote
+const float RAIO_DOMINIO = 0.05f;  // idem para o domínio (círculo / esfera)
+
+uint64_t splitmix(uint64_t& estado) {
+    uint64_t z = (estado += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+float uniforme(uint64_t& estado) { return (splitmix(estado) >> 40) * (1.0f / (1 << 24)); }
+
+struct Tarefa {
+    int32_t pai;          // < 0: vértice global (-1 - i); >= 0: vértice local do bloco
+    glm::vec3 inicio, direcao;
+    int64_t terminais;
+    uint64_t semente;
+};
+
+// Saída de uma subárvore. Cada segmento cria exatamente um vértice (o seu fim),
+// então o segmento k do bloco termina no vértice local k.
+struct Bloco {
+    std::vector<float> pos;
+    std::vector<int32_t> pais;
+    std::vector<float> raios;
+};
+
+struct Parametros {
+    int dimensao = 2;
+    int64_t terminaisTotal = 1;
+    float raioTerminal = 0.0f;
+};
+
+glm::vec3 girar(const glm::vec3& v, const glm::vec3& eixo, float angulo) {
+    // Rodrigues
+    float c = std::cos(angulo), s = std::sin(angulo);
+    return v * c + glm::cross(eixo, v) * s + eixo * glm::dot(eixo, v) * (1.0f - c);
+}
+
+// Emite o segmento da tarefa e devolve as filhas (se não for terminal)
+int expandir(const Tarefa& t, Bloco& b, bool global, const Parametros& prm, Tarefa filhas[2]) {
+    uint64_t rng = t.semente;
+    float r0 = prm.raioTerminal * std::cbrt((float)t.terminais);
+    float fracao = (float)t.terminais / (float)prm.terminaisTotal;
+    float comprimento = 0.6f * RAIO_DOMINIO * std::pow(fracao, 1.0f / prm.dimensao) * (0.7f + 0.3f * uniforme(rng));
+
+    glm::vec3 direcao = t.direcao;
+    glm::vec3 fim = t.inicio + direcao * comprimento;
+    if (glm::length(fim) > RAIO_DOMINIO) {
+        // Saiu do domínio: puxa de volta para o centro
+        direcao = glm::normalize(direcao - glm::normalize(fim));
+        fim = t.inicio + direcao * comprimento;
+    }
+
+    int32_t local = (int32_t)b.raios.size();
+    b.pos.push_back(fim.x); b.pos.push_back(fim.y); b.pos.push_back(fim.z);
+    b.pais.push_back(t.pai);
+    b.raios.push_back(r0);
+    if (t.terminais <= 1) return 0;
+
+    int64_t n1 = (int64_t)std::llround(t.terminais * (0.25f + 0.5f * uniforme(rng)));
+    n1 = std::max<int64_t>(1, std::min<int64_t>(t.terminais - 1, n1));
+    int64_t n2 = t.terminais - n1;
+    float r1 = prm.raioTerminal * std::cbrt((float)n1), r2 = prm.raioTerminal * std::cbrt((float)n2);
+
+    // Ângulos ótimos de Murray para a bifurcação r0 -> (r1, r2)
+    auto angulo = [&](float a, float b2) {
+        float c = (r0*r0*r0*r0 + a*a*a*a - b2*b2*b2*b2) / (2.0f * r0*r0 * a*a);
+        return std::acos(std::max(-1.0f, std::min(1.0f, c)));
+    };
+    float theta1 = angulo(r1, r2), theta2 = angulo(r2, r1);
+    if (uniforme(rng) < 0.5f) { theta1 = -theta1; theta2 = -theta2; }
+
+    glm::vec3 eixo(0.0f, 0.0f, 1.0f);
+    if (prm.dimensao == 3) {
+        glm::vec3 aleatorio(uniforme(rng) - 0.5f, uniforme(rng) - 0.5f, uniforme(rng) - 0.5f);
+        glm::vec3 c = glm::cross(direcao, aleatorio);
+        if (glm::length(c) > 1e-6f) eixo = glm::normalize(c);
+        else eixo = glm::normalize(glm::cross(direcao, glm::vec3(1.0f, 0.0f, 0.0f)));
+    }
+
+    int32_t pai = global ? -1 - (1 + local) : local;   // vértice 0 global é o início da raiz
+    filhas[0] = {pai, fim, glm::normalize(girar(direcao, eixo, theta1)), n1, splitmix(rng)};
+    filhas[1] = {pai, fim, glm::normalize(girar(direcao, eixo, -theta2)), n2, splitmix(rng)};
+    return 2;
+}
+
+void crescerSubarvore(const Tarefa& raiz, Bloco& b, const Parametros& prm) {
+    std::vector<Tarefa> pilha = {raiz};
+    Tarefa filhas[2];
+    while (!pilha.empty()) {
+        Tarefa t = pilha.back(); pilha.pop_back();
+        int n = expandir(t, b, false, prm, filhas);
+        for (int i = n - 1; i >= 0; i--) pilha.push_back(filhas[i]);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int64_t segmentos = 100000;
+    int dimensao = 2;
+    std::string formato = "ascii", caminhoSaida;
+    uint64_t semente = 42;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--segmentos" && i + 1 < argc) segmentos = std::atoll(argv[++i]);
+        else if (arg == "--dim" && i + 1 < argc) dimensao = std::atoi(argv[++i]);
+        else if (arg == "--formato" && i + 1 < argc) formato = argv[++i];
+        else if (arg == "--saida" && i + 1 < argc) caminhoSaida = argv[++i];
+        else if (arg == "--semente" && i + 1 < argc) semente = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--threads" && i + 1 < argc) threads = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::cout << "Uso: ./gerar_arvore --segmentos N [--dim 2|3] [--formato ascii|binary|cache]"
+                         " [--saida <arquivo>] [--semente S] [--threads T]" << std::endl;
+            return 1;
+        }
+    }
+    if ((dimensao != 2 && dimensao != 3) || segmentos < 1 || segmentos > INT32_MAX - 1 ||
+        (formato != "ascii" && formato != "binary" && formato != "cache")) {
+        std::cerr << "Parametros invalidos" << std::endl;
+        return 1;
+    }
+    if (caminhoSaida.empty())
+        caminhoSaida = "arvore" + std::to_string(dimensao) + "D_" + std::to_string(segmentos) +
+                       (formato == "cache" ? ".arvb" : ".vtk");
+
+    // Árvore binária com T terminais tem 2T - 1 segmentos
+    Parametros prm;
+    prm.dimensao = dimensao;
+    prm.terminaisTotal = (segmentos + 1) / 2;
+    prm.raioTerminal = RAIO_RAIZ / std::cbrt((float)prm.terminaisTotal);
+    auto t0 = std::chrono::steady_clock::now();
+
+    // 1. Tronco sequencial, em largura, até haver subárvores de sobra para as threads.
+    //    O corte é fixo para que a ordem dos segmentos não dependa de --threads.
+    Bloco tronco;
+    std::deque<Tarefa> fila;
+    fila.push_back({-1, glm::vec3(0.0f, RAIO_DOMINIO, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f), prm.terminaisTotal, semente});
+    Tarefa filhas[2];
+    const size_t alvo = 1024;
+    while (!fila.empty() && fila.size() < alvo) {
+        Tarefa t = fila.front(); fila.pop_front();
+        int n = expandir(t, tronco, true, prm, filhas);
+        for (int i = 0; i < n; i++) fila.push_back(filhas[i]);
+    }
+
+    // 2. Subárvores em paralelo, distribuídas sob demanda
+    std::vector<Tarefa> tarefas(fila.begin(), fila.end());
+    std::vector<Bloco> blocos(tarefas.size());
+    std::atomic<size_t> proxima{0};
+    auto trabalhador = [&]() {
+        for (size_t i; (i = proxima.fetch_add(1)) < tarefas.size();) crescerSubarvore(tarefas[i], blocos[i], prm);
+    };
+    std::vector<std::thread> ts;
+    for (int i = 1; i < threads; i++) ts.emplace_back(trabalhador);
+    trabalhador();
+    for (auto& t : ts) t.join();
+
+    // 3. Junta os blocos: vértice 0 = início da raiz, depois o tronco, depois cada bloco
+    std::vector<size_t> deslocamento(blocos.size() + 1);
+    size_t base = 1 + tronco.raios.size();
+    for (size_t i = 0; i < blocos.size(); i++) { deslocamento[i] = base; base += blocos[i].raios.size(); }
+    size_t nSegmentos = base - 1, nVertices = base;
+
+    std::vector<float> pos(nVertices * 3);
+    std::vector<int32_t> indices(nSegmentos * 2);
+    std::vector<float> raios(nSegmentos);
+    pos[0] = 0.0f; pos[1] = RAIO_DOMINIO; pos[2] = 0.0f;
+    auto copiar = [&](const Bloco& b, size_t desl) {
+        for (size_t k = 0; k < b.raios.size(); k++) {
+            size_t v = desl + k, s = v - 1;
+            pos[3*v] = b.pos[3*k]; pos[3*v+1] = b.pos[3*k+1]; pos[3*v+2] = b.pos[3*k+2];
+            int32_t pai = b.pais[k];
+            indices[2*s] = pai < 0 ? -1 - pai : (int32_t)(desl + pai);
+            indices[2*s+1] = (int32_t)v;
+            raios[s] = b.raios[k];
+        }
+    };
+    copiar(tronco, 1);
+    proxima = 0;
+    auto juntar = [&]() {
+        for (size_t i; (i = proxima.fetch_add(1)) < blocos.size();) {
+            copiar(blocos[i], deslocamento[i]);
+            blocos[i] = Bloco();   // libera memória cedo
+        }
+    };
+    ts.clear();
+    for (int i = 1; i < threads; i++) ts.emplace_back(juntar);
+    juntar();
+    for (auto& t : ts) t.join();
+    auto t1 = std::chrono::steady_clock::now();
+    std::cout << "Gerados " << nSegmentos << " segmentos (" << dimensao << "D) em "
+              << std::chrono::duration<double>(t1 - t0).count() << " s com " << threads << " threads" << std::endl;
+
+    // 4. Grava
+    bool ok;
+    if (formato == "cache")
+        ok = salvarCacheBruto(caminhoSaida, pos.data(), nVertices, indices.data(), raios.data(), nSegmentos);
+    else
+        ok = salvarVTKBruto(caminhoSaida, formato == "binary" ? FormatoVTK::Binario : FormatoVTK::ASCII,
+                            pos.data(), nVertices, indices.data(), nSegmentos, {{"raio", raios.data()}}, threads);
+    if (!ok) return 1;
+    auto t2 = std::chrono::steady_clock::now();
+    std::cout << "Gravado " << caminhoSaida << " em " << std::chrono::duration<double>(t2 - t1).count() << " s" << std::endl;
+    return 0;
+}
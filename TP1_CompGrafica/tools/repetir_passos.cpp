@@ -0,0 +1,161 @@
+// --- PRODUTOR DE REFERÊNCIA PARA O MODO AO VIVO ---
+// Repete os steps de uma árvore do pacote no anel de ingestão, como faria uma
+// simulação CCO rodando: o primeiro passo vai inteiro (REINICIAR + tudo) e os
+// seguintes só com a diferença para o anterior (pontos novos ou movidos,
+// segmentos novos ou religados, raios). Se um visualizador entra no meio ou o
+// anel enche sem ninguém drenar, o passo seguinte vai inteiro de novo.
+// O anel fica em /dev/shm depois de sair, para o visualizador continuar ligado.
+//
+// Uso: ./repetir_passos --dim 2 --nterm 256 [--dados <raiz>]... [--anel /cco_ao_vivo]
+//                       [--intervalo ms] [--espera ms] [--laco]
+//      ./repetir_passos [opções] passo1.vtk passo2.vtk ...
+// Em outro terminal: ./meu_app --ao-vivo /cco_ao_vivo
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "anel_ingestao.h"
+#include "carregador_vtk.h"
+#include "catalogo.h"
+
+namespace {
+
+// Registros de um passo: a diferença para 'anterior', ou o estado completo sem ele
+void montarRegistros(const Arvore2D* anterior, const Arvore2D& atual, int passo, std::vector<RegistroIngestao>& saida) {
+    saida.clear();
+    size_t nV0 = anterior ? anterior->vertices.size() : 0;
+    size_t nS0 = anterior ? anterior->segmentos.size() : 0;
+    RegistroIngestao r;
+    if (!anterior) {
+        r.tipo = REG_REINICIAR;
+        saida.push_back(r);
+    }
+    for (size_t i = 0; i < atual.vertices.size(); i++) {
+        const glm::vec3& p = atual.vertices[i].posicao;
+        if (i < nV0 && anterior->vertices[i].posicao == p) continue;
+        r = RegistroIngestao();
+        r.tipo = REG_PONTO; r.indice = (uint32_t)i;
+        r.x = p.x; r.y = p.y; r.z = p.z;
+        saida.push_back(r);
+    }
+    for (size_t i = 0; i < atual.segmentos.size(); i++) {
+        const Segmento& s = atual.segmentos[i];
+        r = RegistroIngestao();
+        r.indice = (uint32_t)i;
+        r.raio = s.raio;
+        if (i < nS0) {
+            const Segmento& s0 = anterior->segmentos[i];
+            if (s0.indicePontoA == s.indicePontoA && s0.indicePontoB == s.indicePontoB) {
+                if (s0.raio == s.raio) continue;
+                r.tipo = REG_RAIO;
+                saida.push_back(r);
+                continue;
+            }
+        }
+        r.tipo = REG_SEGMENTO;
+        r.a = (uint32_t)s.indicePontoA; r.b = (uint32_t)s.indicePontoB;
+        saida.push_back(r);
+    }
+    r = RegistroIngestao();
+    r.tipo = REG_PASSO; r.indice = (uint32_t)passo;
+    saida.push_back(r);
+}
+
+// Publica tudo, esperando o consumidor abrir espaço; false se ficou 'esperaMs' sem andar
+bool publicarTudo(AnelIngestao& anel, const std::vector<RegistroIngestao>& registros, int esperaMs) {
+    size_t feitos = 0;
+    auto ultimoAvanco = std::chrono::steady_clock::now();
+    while (feitos < registros.size()) {
+        size_t n = anel.publicar(registros.data() + feitos, registros.size() - feitos);
+        feitos += n;
+        auto agora = std::chrono::steady_clock::now();
+        if (n > 0) ultimoAvanco = agora;
+        else if (agora - ultimoAvanco > std::chrono::milliseconds(esperaMs)) return false;
+        else std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string nomeAnel = "/cco_ao_vivo";
+    std::vector<std::string> raizes, arquivos;
+    int dimensao = 0, nTerm = 0;
+    int intervaloMs = 200, esperaMs = 1000;
+    bool laco = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--anel" && i + 1 < argc) nomeAnel = argv[++i];
+        else if (arg == "--dim" && i + 1 < argc) dimensao = std::atoi(argv[++i]);
+        else if (arg == "--nterm" && i + 1 < argc) nTerm = std::atoi(argv[++i]);
+        else if (arg == "--dados" && i + 1 < argc) raizes.push_back(argv[++i]);
+        else if (arg == "--intervalo" && i + 1 < argc) intervaloMs = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--espera" && i + 1 < argc) esperaMs = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--laco") laco = true;
+        else arquivos.push_back(arg);
+    }
+
+    // Sem arquivos na linha de comando: os steps do pacote para (dim, Nterm), em ordem
+    if (arquivos.empty() && dimensao != 0 && nTerm != 0) {
+        if (raizes.empty()) raizes.push_back("../TP_CCO_Pacote_Dados");
+        Catalogo catalogo;
+        catalogo.atualizar(raizes);
+        for (const EntradaCatalogo& e : catalogo.entradas())
+            if (e.resumo.dimensao == dimensao && e.nTerm == nTerm) arquivos.push_back(e.caminho);
+    }
+    if (arquivos.empty()) {
+        std::cout << "Uso: ./repetir_passos --dim 2|3 --nterm N [--dados <raiz>]... [--anel <nome>]"
+                  << " [--intervalo ms] [--espera ms] [--laco]" << std::endl;
+        std::cout << "     ./repetir_passos [opcoes] passo1.vtk passo2.vtk ..." << std::endl;
+        return 1;
+    }
+
+    AnelIngestao anel;
+    std::vector<RegistroIngestao> registros;
+    Arvore2D anterior;
+    bool temAnterior = false, reenviar = false;
+    size_t totalRegistros = 0;
+    do {
+        for (size_t k = 0; k < arquivos.size(); k++) {
+            Arvore2D atual = carregarArvore(arquivos[k]);
+            if (atual.vertices.empty()) continue;
+            if (!anel.aberto()) {
+                if (dimensao == 0) dimensao = detectarDimensao(atual);
+                if (!anel.criar(nomeAnel, dimensao)) {
+                    std::cerr << "ERRO: nao consegui criar o anel " << nomeAnel << std::endl;
+                    return 1;
+                }
+                std::cout << "Anel " << nomeAnel << " (" << dimensao << "D, " << AnelIngestao::CAPACIDADE_PADRAO
+                          << " registros); " << arquivos.size() << " passo(s)" << std::endl;
+            }
+            int nt, passo;
+            std::string nome = std::filesystem::path(arquivos[k]).filename().string();
+            if (!lerNomePacote(nome, nt, passo)) passo = (int)k;
+
+            // Diferença só se o passo anterior chegou inteiro e a árvore não encolheu
+            bool pedido = anel.estadoPedido();
+            bool completo = !temAnterior || reenviar || pedido || atual.vertices.size() < anterior.vertices.size() ||
+                            atual.segmentos.size() < anterior.segmentos.size();
+            montarRegistros(completo ? nullptr : &anterior, atual, passo, registros);
+            bool ok = publicarTudo(anel, registros, esperaMs);
+            if (ok) totalRegistros += registros.size();
+            std::cout << "Passo " << passo << ": " << atual.segmentos.size() << " segmentos, " << registros.size()
+                      << " registros" << (completo ? " (estado completo)" : "")
+                      << (ok ? "" : " -- anel cheio, sem consumidor? o proximo vai inteiro") << std::endl;
+            reenviar = !ok;
+            anterior = std::move(atual);
+            temAnterior = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(intervaloMs));
+        }
+        temAnterior = false;   // no laço, recomeça do primeiro passo com REINICIAR
+    } while (laco);
+    std::cout << totalRegistros << " registros publicados" << std::endl;
+    return 0;
+}
@@ -0,0 +1,520 @@
+// --- SERVIDOR DE RENDERIZAÇÃO (SOCKET UNIX) ---
+// Mantém árvores carregadas e atende scripts de análise sem abrir um processo
+// por pedido: carregar arquivo, renderizar uma câmera em PNG (ou RGBA cru),
+// selecionar o vaso num pixel e estatísticas. Cada conexão tem a sua thread;
+// as árvores carregadas são somente leitura e compartilhadas entre elas.
+// A renderização é na CPU (raster_software), então não precisa de GPU nem de
+// display.
+//
+// Protocolo binário, na ordem de bytes da máquina (cliente e servidor são
+// locais). Pedido: {u32 magica = 0x52524343, u32 comando, u32 tamanho} + carga.
+// Resposta: {u32 estado (0 = ok), u32 tamanho} + carga; em erro a carga é a
+// mensagem em texto.
+//   1 CARREGAR      carga = caminho          -> {u32 id, u32 dimensao, u64 pontos, u64 segmentos}
+//   2 RENDERIZAR    {u32 id, u32 largura, u32 altura, u32 formato (0 = RGBA, 1 = PNG), f32 mvp[16]}
+//                                            -> {u64 bytes, u32 largura, u32 altura, u32 formato}
+//                   e a imagem num descritor de memória compartilhada (SCM_RIGHTS) com
+//                   'bytes' bytes: o cliente faz mmap, sem cópia pelo socket. mvp toda
+//                   zero enquadra a árvore inteira (ortográfica em 2D, órbita em 3D).
+//   3 SELECIONAR    {u32 id, u32 largura, u32 altura, f32 x, f32 y, f32 mvp[16]}
+//                                            -> {i32 segmento (-1 = nenhum), f32 distancia em px}
+//   4 ESTATISTICAS  sem carga                -> JSON em texto
+//   5 DESCARREGAR   {u32 id}                 -> sem carga
+// A mvp é coluna a coluna (glm::value_ptr), a mesma do visualizador.
+//
+// Uso: ./servidor_render [--socket <caminho>]
+//      ./servidor_render --cliente <socket> <arvore> <saida.png> [largura altura]   (teste rápido)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "arena_arvore.h"
+#include "camera_orbita.h"
+#include "carregador_vtk.h"
+#include "png_simples.h"
+#include "raster_software.h"
+
+namespace {
+
+const uint32_t MAGICA = 0x52524343;
+const uint32_t MAX_LADO = 16384;
+const uint32_t MAX_CARGA = 1 << 20;
+const size_t MAX_BYTES_RENDER = size_t(2) << 30;   // buffers de todos os renders em andamento
+
+enum Comando : uint32_t { CARREGAR = 1, RENDERIZAR = 2, SELECIONAR = 3, ESTATISTICAS = 4, DESCARREGAR = 5 };
+enum CodigoResposta : uint32_t { OK = 0, ERRO_PEDIDO = 1, ERRO_ARVORE = 2, ERRO_INTERNO = 3 };
+
+struct Cabecalho { uint32_t magica, comando, tamanho; };
+struct CabecalhoResposta { uint32_t estado, tamanho; };
+struct PedidoRender { uint32_t id, largura, altura, formato; float mvp[16]; };
+struct PedidoSelecao { uint32_t id, largura, altura; float x, y; float mvp[16]; };
+struct RespostaCarga { uint32_t id, dimensao; uint64_t pontos, segmentos; };
+struct RespostaRender { uint64_t bytes; uint32_t largura, altura, formato; };
+struct RespostaSelecao { int32_t segmento; float distanciaPx; };
+
+// --- ÁRVORES RESIDENTES ---
+struct ArvoreResidente {
+    std::string caminho;
+    std::unique_ptr<ArenaArvore> arena;   // declarada antes da árvore: é destruída por último
+    Arvore2D arvore;
+    int dimensao = 2;
+    glm::vec3 minimo = glm::vec3(0.0f), maximo = glm::vec3(0.0f);
+    ArvoreResidente(std::unique_ptr<ArenaArvore> a) : arena(std::move(a)), arvore(arena->recurso()) {}
+};
+
+std::shared_mutex travaArvores;
+std::map<uint32_t, std::shared_ptr<const ArvoreResidente>> arvores;
+uint32_t proximoId = 1;
+
+// Memória de trabalho dos renders: quem não cabe espera os outros terminarem
+std::mutex travaOrcamento;
+std::condition_variable orcamentoLiberado;
+size_t bytesEmUso = 0;
+
+struct ReservaRender {
+    size_t bytes;
+    explicit ReservaRender(size_t b) : bytes(b) {
+        std::unique_lock<std::mutex> trava(travaOrcamento);
+        orcamentoLiberado.wait(trava, [&] { return bytesEmUso + bytes <= MAX_BYTES_RENDER; });
+        bytesEmUso += bytes;
+    }
+    ~ReservaRender() {
+        { std::lock_guard<std::mutex> trava(travaOrcamento); bytesEmUso -= bytes; }
+        orcamentoLiberado.notify_all();
+    }
+};
+
+std::atomic<uint64_t> conexoes{0}, pedidos[6] = {}, erros{0}, bytesImagem{0}, usRender{0};
+const auto inicioServidor = std::chrono::steady_clock::now();
+
+std::shared_ptr<const ArvoreResidente> arvorePorId(uint32_t id) {
+    std::shared_lock<std::shared_mutex> trava(travaArvores);
+    auto it = arvores.find(id);
+    return it == arvores.end() ? nullptr : it->second;
+}
+
+// --- E/S NO SOCKET ---
+bool lerTudo(int fd, void* destino, size_t n) {
+    char* p = (char*)destino;
+    while (n > 0) {
+        ssize_t r = recv(fd, p, n, 0);
+        if (r <= 0) return false;
+        p += r; n -= (size_t)r;
+    }
+    return true;
+}
+
+bool escreverTudo(int fd, const void* origem, size_t n) {
+    const char* p = (const char*)origem;
+    while (n > 0) {
+        ssize_t r = send(fd, p, n, MSG_NOSIGNAL);
+        if (r <= 0) return false;
+        p += r; n -= (size_t)r;
+    }
+    return true;
+}
+
+// Cabeçalho + carga; com 'descritor' >= 0 ele vai junto, na mesma mensagem
+bool responder(int fd, uint32_t estado, const void* carga, uint32_t tamanho, int descritor = -1) {
+    std::vector<char> msg(sizeof(CabecalhoResposta) + tamanho);
+    CabecalhoResposta c{estado, tamanho};
+    std::memcpy(msg.data(), &c, sizeof(c));
+    if (tamanho) std::memcpy(msg.data() + sizeof(c), carga, tamanho);
+    if (descritor < 0) return escreverTudo(fd, msg.data(), msg.size());
+
+    iovec iov{msg.data(), msg.size()};
+    alignas(cmsghdr) char controle[CMSG_SPACE(sizeof(int))] = {};
+    msghdr m{};
+    m.msg_iov = &iov; m.msg_iovlen = 1;
+    m.msg_control = controle; m.msg_controllen = sizeof(controle);
+    cmsghdr* cm = CMSG_FIRSTHDR(&m);
+    cm->cmsg_level = SOL_SOCKET; cm->cmsg_type = SCM_RIGHTS; cm->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(cm), &descritor, sizeof(int));
+    ssize_t r = sendmsg(fd, &m, MSG_NOSIGNAL);
+    if (r <= 0) return false;
+    return (size_t)r == msg.size() || escreverTudo(fd, msg.data() + r, msg.size() - (size_t)r);
+}
+
+bool responderErro(int fd, uint32_t estado, const std::string& mensagem) {
+    erros++;
+    return responder(fd, estado, mensagem.data(), (uint32_t)mensagem.size());
+}
+
+// Memória anônima que só existe pelo descritor (some quando o último fecha)
+int criarMemoria(size_t bytes) {
+#ifdef __linux__
+    int fd = memfd_create("cco_render", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#else
+    static std::atomic<int> contador{0};
+    std::string nome = "/cco_render_" + std::to_string(getpid()) + "_" + std::to_string(contador++);
+    int fd = shm_open(nome.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) shm_unlink(nome.c_str());
+#endif
+    if (fd < 0) return -1;
+    if (ftruncate(fd, (off_t)bytes) != 0) { close(fd); return -1; }
+    return fd;
+}
+
+// --- COMANDOS ---
+glm::mat4 cameraDoPedido(const float* mvp, const ArvoreResidente& a, int largura, int altura) {
+    glm::mat4 m = glm::make_mat4(mvp);
+    bool zerada = true;
+    for (int i = 0; i < 16; i++) zerada = zerada && mvp[i] == 0.0f;
+    if (!zerada) return m;
+    float aspecto = (float)largura / altura;
+    glm::vec3 centro = 0.5f * (a.minimo + a.maximo);
+    if (a.dimensao == 3) {
+        CameraOrbita camera;
+        camera.enquadrar(centro, 0.5f * glm::length(a.maximo - a.minimo));
+        return camera.projecao(aspecto) * camera.visao();
+    }
+    glm::vec3 ext = 0.55f * (a.maximo - a.minimo) + glm::vec3(1e-6f);
+    float meiaAltura = std::max(ext.y, ext.x / aspecto);
+    return glm::ortho(centro.x - meiaAltura * aspecto, centro.x + meiaAltura * aspecto,
+                      centro.y - meiaAltura, centro.y + meiaAltura, -1.0f, 1.0f);
+}
+
+bool carregar(int fd, const std::string& caminho) {
+    {
+        std::shared_lock<std::shared_mutex> trava(travaArvores);
+        for (auto& [id, a] : arvores)
+            if (a->caminho == caminho) {
+                RespostaCarga r{id, (uint32_t)a->dimensao, a->arvore.vertices.size(), a->arvore.segmentos.size()};
+                return responder(fd, OK, &r, sizeof(r));
+            }
+    }
+    // Carga fora da trava: outras conexões continuam renderizando
+    std::error_code erro;
+    uintmax_t tamanho = std::filesystem::file_size(caminho, erro);
+    auto nova = std::make_shared<ArvoreResidente>(
+        std::make_unique<ArenaArvore>(erro ? RecursoPaginasGrandes::PAGINA : (size_t)tamanho));
+    nova->caminho = caminho;
+    nova->arvore = carregarArvore(caminho, nova->arena->recurso());
+    // O carregador devolve a árvore vazia se o arquivo não passa na validação
+    if (nova->arvore.vertices.empty() || nova->arvore.segmentos.empty())
+        return responderErro(fd, ERRO_ARVORE, "nao consegui carregar " + caminho);
+    nova->dimensao = detectarDimensao(nova->arvore);
+    nova->minimo = nova->maximo = nova->arvore.vertices[0].posicao;
+    for (const Ponto& p : nova->arvore.vertices) {
+        nova->minimo = glm::min(nova->minimo, p.posicao);
+        nova->maximo = glm::max(nova->maximo, p.posicao);
+    }
+    uint32_t id = 0;
+    {
+        // Outra conexão pode ter carregado o mesmo caminho enquanto esta lia
+        std::unique_lock<std::shared_mutex> trava(travaArvores);
+        for (auto& [outro, a] : arvores)
+            if (a->caminho == caminho) { id = outro; nova = std::const_pointer_cast<ArvoreResidente>(a); break; }
+        if (id == 0) {
+            id = proximoId++;
+            arvores[id] = nova;
+        }
+    }
+    std::cout << "Carregada " << caminho << " (id " << id << ", " << nova->arvore.segmentos.size() << " segmentos)" << std::endl;
+    RespostaCarga r{id, (uint32_t)nova->dimensao, nova->arvore.vertices.size(), nova->arvore.segmentos.size()};
+    return responder(fd, OK, &r, sizeof(r));
+}
+
+bool renderizar(int fd, const PedidoRender& p) {
+    auto a = arvorePorId(p.id);
+    if (!a) return responderErro(fd, ERRO_ARVORE, "arvore " + std::to_string(p.id) + " nao carregada");
+    if (p.largura == 0 || p.altura == 0 || p.largura > MAX_LADO || p.altura > MAX_LADO || p.formato > 1)
+        return responderErro(fd, ERRO_PEDIDO, "tamanho ou formato invalido");
+    auto t0 = std::chrono::steady_clock::now();
+    int w = (int)p.largura, h = (int)p.altura;
+    glm::mat4 mvp = cameraDoPedido(p.mvp, *a, w, h);
+    size_t bytesRGBA = (size_t)w * h * 4;
+    size_t bytes = p.formato == 1 ? tamanhoPNG(w, h) : bytesRGBA;
+    // Saída + RGBA intermediário do PNG + z-buffer do 3D
+    size_t trabalho = bytes + (p.formato == 1 ? bytesRGBA : 0) + (a->dimensao == 3 ? (size_t)w * h * sizeof(float) : 0);
+    if (trabalho > MAX_BYTES_RENDER) return responderErro(fd, ERRO_PEDIDO, "imagem grande demais");
+    ReservaRender reserva(trabalho);
+
+    int memoria = criarMemoria(bytes);
+    if (memoria < 0) return responderErro(fd, ERRO_INTERNO, "sem memoria compartilhada");
+    void* mapa = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, memoria, 0);
+    if (mapa == MAP_FAILED) { close(memoria); return responderErro(fd, ERRO_INTERNO, "mmap falhou"); }
+    try {
+        if (p.formato == 1) {
+            // PNG: a imagem passa por um buffer temporário e é codificada direto no mapa
+            std::vector<uint8_t> rgba(bytesRGBA);
+            rasterizarArvore(a->arvore, mvp, w, h, a->dimensao == 3, rgba.data());
+            codificarPNG(rgba.data(), w, h, (uint8_t*)mapa);
+        } else {
+            rasterizarArvore(a->arvore, mvp, w, h, a->dimensao == 3, (uint8_t*)mapa);
+        }
+    } catch (...) {
+        munmap(mapa, bytes);
+        close(memoria);
+        throw;
+    }
+    munmap(mapa, bytes);
+#ifdef __linux__
+    // Selada: o cliente pode confiar no tamanho e em que ninguém mais escreve
+    fcntl(memoria, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+#endif
+    usRender += (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+    bytesImagem += bytes;
+    RespostaRender r{bytes, p.largura, p.altura, p.formato};
+    bool ok = responder(fd, OK, &r, sizeof(r), memoria);
+    close(memoria);
+    return ok;
+}
+
+bool selecionar(int fd, const PedidoSelecao& p) {
+    auto a = arvorePorId(p.id);
+    if (!a) return responderErro(fd, ERRO_ARVORE, "arvore " + std::to_string(p.id) + " nao carregada");
+    if (p.largura == 0 || p.altura == 0) return responderErro(fd, ERRO_PEDIDO, "tamanho invalido");
+    glm::mat4 mvp = cameraDoPedido(p.mvp, *a, (int)p.largura, (int)p.altura);
+    RespostaSelecao r{-1, 0.0f};
+    r.segmento = segmentoNoPixel(a->arvore, mvp, (int)p.largura, (int)p.altura, p.x, p.y, &r.distanciaPx);
+    return responder(fd, OK, &r, sizeof(r));
+}
+
+bool estatisticas(int fd) {
+    std::ostringstream j;
+    size_t nArvores, segmentos = 0, bytesArena = 0;
+    {
+        std::shared_lock<std::shared_mutex> trava(travaArvores);
+        nArvores = arvores.size();
+        for (auto& [id, a] : arvores) { segmentos += a->arvore.segmentos.size(); bytesArena += a->arena->bytesReservados(); }
+    }
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicioServidor).count();
+    j << "{\"segundos\": " << s << ", \"conexoes\": " << conexoes << ", \"arvores\": " << nArvores
+      << ", \"segmentos\": " << segmentos << ", \"bytes_arenas\": " << bytesArena
+      << ", \"pedidos\": {\"carregar\": " << pedidos[CARREGAR] << ", \"renderizar\": " << pedidos[RENDERIZAR]
+      << ", \"selecionar\": " << pedidos[SELECIONAR] << ", \"estatisticas\": " << pedidos[ESTATISTICAS]
+      << ", \"descarregar\": " << pedidos[DESCARREGAR] << "}, \"erros\": " << erros
+      << ", \"ms_render\": " << usRender / 1000.0 << ", \"bytes_imagem\": " << bytesImagem << "}";
+    std::string texto = j.str();
+    return responder(fd, OK, texto.data(), (uint32_t)texto.size());
+}
+
+bool despachar(int fd, uint32_t comando, const std::vector<char>& carga) {
+    switch (comando) {
+    case CARREGAR:
+        return carregar(fd, std::string(carga.begin(), carga.end()));
+    case RENDERIZAR: {
+        PedidoRender p;
+        if (carga.size() != sizeof(p)) return responderErro(fd, ERRO_PEDIDO, "carga de RENDERIZAR invalida");
+        std::memcpy(&p, carga.data(), sizeof(p));
+        return renderizar(fd, p);
+    }
+    case SELECIONAR: {
+        PedidoSelecao p;
+        if (carga.size() != sizeof(p)) return responderErro(fd, ERRO_PEDIDO, "carga de SELECIONAR invalida");
+        std::memcpy(&p, carga.data(), sizeof(p));
+        return selecionar(fd, p);
+    }
+    case ESTATISTICAS:
+        return estatisticas(fd);
+    case DESCARREGAR: {
+        uint32_t id = 0;
+        if (carga.size() == sizeof(id)) std::memcpy(&id, carga.data(), sizeof(id));
+        size_t removidas;
+        {
+            // Quem está renderizando essa árvore segura o shared_ptr até terminar
+            std::unique_lock<std::shared_mutex> trava(travaArvores);
+            removidas = arvores.erase(id);
+        }
+        return removidas ? responder(fd, OK, nullptr, 0) : responderErro(fd, ERRO_ARVORE, "arvore nao carregada");
+    }
+    default:
+        return responderErro(fd, ERRO_PEDIDO, "comando desconhecido");
+    }
+}
+
+void atender(int fd) {
+    conexoes++;
+    std::vector<char> carga;
+    while (true) {
+        Cabecalho c;
+        if (!lerTudo(fd, &c, sizeof(c))) break;
+        if (c.magica != MAGICA || c.tamanho > MAX_CARGA) { responderErro(fd, ERRO_PEDIDO, "cabecalho invalido"); break; }
+        carga.resize(c.tamanho);
+        if (c.tamanho && !lerTudo(fd, carga.data(), c.tamanho)) break;
+        if (c.comando >= CARREGAR && c.comando <= DESCARREGAR) pedidos[c.comando]++;
+
+        bool ok;
+        try {
+            ok = despachar(fd, c.comando, carga);
+        } catch (const std::exception& e) {
+            // Um pedido que falha (ex.: bad_alloc numa árvore enorme) responde erro e não derruba o servidor
+            ok = responderErro(fd, c.comando == CARREGAR ? ERRO_ARVORE : ERRO_INTERNO, std::string("falha: ") + e.what());
+        }
+        if (!ok) break;
+    }
+    close(fd);
+}
+
+// --- SERVIDOR ---
+char caminhoSocket[sizeof(sockaddr_un::sun_path)] = "";
+
+void aoSinal(int) {
+    unlink(caminhoSocket);
+    _exit(0);
+}
+
+int abrirSocket(const std::string& caminho, bool servidor) {
+    sockaddr_un endereco{};
+    if (caminho.size() >= sizeof(endereco.sun_path)) {
+        std::cerr << "ERRO: caminho do socket longo demais: " << caminho << std::endl;
+        return -1;
+    }
+    endereco.sun_family = AF_UNIX;
+    std::strcpy(endereco.sun_path, caminho.c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (servidor) {
+        unlink(caminho.c_str());   // sobra de uma execução interrompida
+        if (bind(fd, (sockaddr*)&endereco, sizeof(endereco)) != 0 || listen(fd, 64) != 0) {
+            std::cerr << "ERRO: nao consegui escutar em " << caminho << ": " << std::strerror(errno) << std::endl;
+            close(fd);
+            return -1;
+        }
+    } else if (connect(fd, (sockaddr*)&endereco, sizeof(endereco)) != 0) {
+        std::cerr << "ERRO: nao consegui conectar em " << caminho << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int servir(const std::string& caminho) {
+    int escuta = abrirSocket(caminho, true);
+    if (escuta < 0) return 1;
+    std::strcpy(caminhoSocket, caminho.c_str());
+    std::signal(SIGINT, aoSinal);
+    std::signal(SIGTERM, aoSinal);
+    std::cout << "Servidor em " << caminho << " (Ctrl+C encerra)" << std::endl;
+    while (true) {
+        int fd = accept4(escuta, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "ERRO: accept: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        std::thread(atender, fd).detach();
+    }
+    close(escuta);
+    unlink(caminho.c_str());
+    return 1;
+}
+
+// --- CLIENTE DE TESTE ---
+bool pedir(int fd, uint32_t comando, const void* carga, uint32_t tamanho, std::vector<char>& resposta, int* descritor = nullptr) {
+    Cabecalho c{MAGICA, comando, tamanho};
+    if (!escreverTudo(fd, &c, sizeof(c)) || (tamanho && !escreverTudo(fd, carga, tamanho))) return false;
+    CabecalhoResposta r;
+    iovec iov{&r, sizeof(r)};
+    alignas(cmsghdr) char controle[CMSG_SPACE(sizeof(int))] = {};
+    msghdr m{};
+    m.msg_iov = &iov; m.msg_iovlen = 1;
+    m.msg_control = controle; m.msg_controllen = sizeof(controle);
+    ssize_t n = recvmsg(fd, &m, MSG_CMSG_CLOEXEC);
+    if (n <= 0) return false;
+    if ((size_t)n < sizeof(r) && !lerTudo(fd, (char*)&r + n, sizeof(r) - (size_t)n)) return false;
+    cmsghdr* cm = CMSG_FIRSTHDR(&m);
+    if (descritor) *descritor = -1;
+    if (cm && cm->cmsg_type == SCM_RIGHTS) {
+        int recebido;
+        std::memcpy(&recebido, CMSG_DATA(cm), sizeof(int));
+        if (descritor) *descritor = recebido;
+        else close(recebido);
+    }
+    resposta.resize(r.tamanho);
+    if (r.tamanho && !lerTudo(fd, resposta.data(), r.tamanho)) return false;
+    if (r.estado != OK) {
+        std::cerr << "ERRO " << r.estado << ": " << std::string(resposta.begin(), resposta.end()) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int cliente(const std::string& caminho, const std::string& arquivo, const std::string& saida, uint32_t largura, uint32_t altura) {
+    int fd = abrirSocket(caminho, false);
+    if (fd < 0) return 1;
+    std::vector<char> resposta;
+    if (!pedir(fd, CARREGAR, arquivo.data(), (uint32_t)arquivo.size(), resposta)) return 1;
+    RespostaCarga carga;
+    std::memcpy(&carga, resposta.data(), sizeof(carga));
+    std::cout << "id " << carga.id << ": " << carga.dimensao << "D, " << carga.segmentos << " segmentos" << std::endl;
+
+    auto t0 = std::chrono::steady_clock::now();
+    PedidoRender p{carga.id, largura, altura, 1, {}};
+    int memoria = -1;
+    if (!pedir(fd, RENDERIZAR, &p, sizeof(p), resposta, &memoria) || memoria < 0) return 1;
+    RespostaRender r;
+    std::memcpy(&r, resposta.data(), sizeof(r));
+    void* mapa = mmap(nullptr, r.bytes, PROT_READ, MAP_SHARED, memoria, 0);
+    close(memoria);
+    if (mapa == MAP_FAILED) return 1;
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    FILE* f = std::fopen(saida.c_str(), "wb");
+    bool gravou = f && std::fwrite(mapa, 1, r.bytes, f) == r.bytes;
+    if (f) std::fclose(f);
+    munmap(mapa, r.bytes);
+    if (!gravou) { std::cerr << "ERRO: nao consegui gravar " << saida << std::endl; return 1; }
+    std::cout << "PNG " << r.largura << "x" << r.altura << " (" << r.bytes << " bytes) em " << ms << " ms -> " << saida << std::endl;
+
+    PedidoSelecao s{carga.id, largura, altura, largura * 0.5f, altura * 0.5f, {}};
+    if (!pedir(fd, SELECIONAR, &s, sizeof(s), resposta)) return 1;
+    RespostaSelecao sel;
+    std::memcpy(&sel, resposta.data(), sizeof(sel));
+    std::cout << "Centro da imagem: segmento " << sel.segmento << " a " << sel.distanciaPx << " px" << std::endl;
+
+    if (!pedir(fd, ESTATISTICAS, nullptr, 0, resposta)) return 1;
+    std::cout << std::string(resposta.begin(), resposta.end()) << std::endl;
+    close(fd);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string socket = "/tmp/cco_render.sock";
+    std::vector<std::string> cli;
+    bool modoCliente = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) socket = argv[++i];
+        else if (arg == "--cliente") modoCliente = true;
+        else cli.push_back(arg);
+    }
+    if (modoCliente && cli.size() >= 3) {
+        uint32_t largura = cli.size() >= 5 ? (uint32_t)std::atoi(cli[3].c_str()) : 800;
+        uint32_t altura = cli.size() >= 5 ? (uint32_t)std::atoi(cli[4].c_str()) : 600;
+        return cliente(cli[0], cli[1], cli[2], largura, altura);
+    }
+    if (modoCliente || !cli.empty()) {
+        std::cout << "Uso: ./servidor_render [--socket <caminho>]" << std::endl;
+        std::cout << "     ./servidor_render --cliente <socket> <arvore> <saida.png> [largura altura]" << std::endl;
+        return 1;
+    }
+    return servir(socket);
+}